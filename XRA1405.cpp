@@ -1,169 +1,1862 @@
 #include "XRA1405.hpp"
 
-void XRA1405_begin(int8_t sck, int8_t miso, int8_t mosi, uint32_t freq)
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+static uint8_t setReadMode(uint8_t commandByte);
+static uint8_t setWriteMode(uint8_t commandByte);
+
+#if XRA1405_ENABLE_STATS
+// Tick source for the frame latency histogram
+static inline uint32_t statsTicks()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    return ESP.getCycleCount();
+#else
+    return micros();
+#endif
+}
+#endif
+
+static bool isCacheableRegister(uint8_t registerCommand)
+{
+    // GSR and ISR reflect the pins and the interrupt latches, everything else only changes when we write it
+    return registerCommand != GSR1 && registerCommand != GSR2 && registerCommand != ISR1 && registerCommand != ISR2;
+}
+
+XRA1405_ArduinoTransport::XRA1405_ArduinoTransport(uint8_t chipSelectPin, SPIClass &spi)
+    : _spi(&spi),
+      _settings(XRA1405_SPI_CLOCK, SPI_ORDER, SPI_MODE),
+      _clock(XRA1405_SPI_CLOCK),
+      _chipSelectPin(chipSelectPin)
+#if defined(ARDUINO_ARCH_ESP32)
+      ,
+      _hardwareChipSelect(false)
+#endif
 {
-    // Ensure the frequency is between 24 MHz and 26 MHz. If not, set to default (26 MHz)
-    if (freq < 24000000 || freq > 26000000)
+#if XRA1405_FAST_CS && defined(ARDUINO_ARCH_ESP32)
+    // Resolve the GPIO set/clear registers once so a CS edge is a single store
+    _chipSelectMask = 1UL << (chipSelectPin % 32);
+    _chipSelectSetRegister = (volatile uint32_t *)GPIO_OUT_W1TS_REG;
+    _chipSelectClearRegister = (volatile uint32_t *)GPIO_OUT_W1TC_REG;
+#if defined(GPIO_OUT1_W1TS_REG)
+    if (chipSelectPin >= 32 && chipSelectPin != XRA1405_NO_PIN)
     {
-        freq = XRA1405_SPI_CLOCK; // Default frequency
+        _chipSelectSetRegister = (volatile uint32_t *)GPIO_OUT1_W1TS_REG;
+        _chipSelectClearRegister = (volatile uint32_t *)GPIO_OUT1_W1TC_REG;
     }
+#endif
+#endif
+}
 
-    SPI.begin(sck, miso, mosi, -1); // Initialize the SPI bus with specified pins
-    SPI.setFrequency(freq);         // Set the SPI clock frequency
+void XRA1405_ArduinoTransport::begin()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_hardwareChipSelect)
+    {
+        return;
+    }
+#endif
+    ::pinMode(_chipSelectPin, OUTPUT);
+    ::digitalWrite(_chipSelectPin, HIGH);
 }
 
-void XRA1405_pinMode(uint8_t chipSelectPin, uint8_t pin, uint8_t mode)
+void XRA1405_ArduinoTransport::beginTransaction(uint32_t clock)
+{
+    if (clock != _clock)
+    {
+        _clock = clock;
+        _settings = SPISettings(clock, SPI_ORDER, SPI_MODE);
+    }
+    _spi->beginTransaction(_settings);
+}
+
+void XRA1405_ArduinoTransport::endTransaction()
+{
+    _spi->endTransaction();
+}
+
+void XRA1405_ArduinoTransport::transfer(uint8_t *data, uint8_t length)
+{
+    // CS only moves inside the transaction, once the bus mode and clock are set.
+    // One transfer call per frame also keeps a hardware CS asserted for the whole frame.
+    selectChip();
+    _spi->transfer(data, length); // Command byte followed by the data bytes
+    deselectChip();
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void XRA1405_ArduinoTransport::setHardwareChipSelect(bool enabled)
+{
+    _hardwareChipSelect = enabled;
+    _spi->setHwCs(enabled);
+}
+#endif
+
+void XRA1405_ArduinoTransport::selectChip()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_hardwareChipSelect)
+    {
+        return; // The SPI peripheral drives CS
+    }
+#endif
+#if XRA1405_FAST_CS && defined(ARDUINO_ARCH_ESP32)
+    *_chipSelectClearRegister = _chipSelectMask;
+#else
+    ::digitalWrite(_chipSelectPin, LOW);
+#endif
+}
+
+void XRA1405_ArduinoTransport::deselectChip()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_hardwareChipSelect)
+    {
+        return;
+    }
+#endif
+#if XRA1405_FAST_CS && defined(ARDUINO_ARCH_ESP32)
+    *_chipSelectSetRegister = _chipSelectMask;
+#else
+    ::digitalWrite(_chipSelectPin, HIGH);
+#endif
+}
+
+XRA1405::XRA1405(uint8_t chipSelectPin, SPIClass &spi, uint32_t freq)
+    : _arduinoTransport(chipSelectPin, spi),
+      _transport(nullptr),
+      _clock(validClock(freq)),
+      _minClock(XRA1405_SPI_CLOCK_MIN),
+      _maxClock(XRA1405_SPI_CLOCK_MAX),
+      _chipSelectPin(chipSelectPin),
+      _cacheEnabled(false),
+      _shadowRegisters(),
+#if !XRA1405_INTERRUPT_ARG
+      _irqSlot(XRA1405_NO_PIN),
+#endif
+      _irqPin(XRA1405_NO_PIN),
+      _irqPending(false),
+      _irqMicros(0),
+      _changeCallback(nullptr),
+      _changeContext(nullptr),
+      _inputGating(false),
+      _gpioState(0),
+      _gpioStateKnown(0),
+      _gpioStateStale(false),
+      _latchedInterrupts(0),
+      _interruptEnable(0)
+#if defined(ARDUINO_ARCH_ESP32)
+      ,
+      _notifyTask(nullptr),
+      _awakeInterrupts()
+#endif
+      ,
+      _locking(true)
+#if XRA1405_THREAD_SAFE
+      ,
+      _busMutex(nullptr)
+#endif
+{
+#if XRA1405_ENABLE_STATS
+    resetStats();
+#endif
+}
+
+XRA1405::XRA1405(XRA1405_Transport &transport, uint32_t freq)
+    : XRA1405(XRA1405_NO_PIN, SPI, freq)
+{
+    _transport = &transport;
+}
+
+void XRA1405::begin(bool useCache)
+{
+    // Deselect the chip before the first frame
+    transport().begin();
+
+    if (useCache)
+    {
+        enableCache();
+    }
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void XRA1405::setHardwareChipSelect(bool enabled)
+{
+    _arduinoTransport.setHardwareChipSelect(enabled);
+}
+#endif
+
+void XRA1405::setClock(uint32_t freq)
+{
+    freq = validClock(freq);
+    if (freq < _minClock)
+    {
+        freq = _minClock;
+    }
+    if (freq > _maxClock)
+    {
+        freq = _maxClock;
+    }
+    _clock = freq;
+}
+
+bool XRA1405::setClockLimits(uint32_t minFreq, uint32_t maxFreq)
+{
+    minFreq = validClock(minFreq);
+    maxFreq = validClock(maxFreq);
+    if (minFreq > maxFreq)
+    {
+        return false;
+    }
+
+    _minClock = minFreq;
+    _maxClock = maxFreq;
+    setClock(_clock);
+    return true;
+}
+
+uint32_t XRA1405::validClock(uint32_t freq)
+{
+    if (freq < XRA1405_SPI_CLOCK_MIN)
+    {
+        return XRA1405_SPI_CLOCK_MIN;
+    }
+    if (freq > XRA1405_SPI_CLOCK_MAX)
+    {
+        return XRA1405_SPI_CLOCK_MAX;
+    }
+    return freq;
+}
+
+void XRA1405::pinMode(uint8_t pin, uint8_t mode)
 {
+    Lock lock(*this);
+
+    // Select every register of the pair before the pin number is reduced to 0-7
     uint8_t gpioConfigRegisterCommand = (pin < 8) ? GCR1 : GCR2;
+    uint8_t threeStateRegisterCommand = (pin < 8) ? TSCR1 : TSCR2;
+    uint8_t pullUpResistorRegisterCommand = (pin < 8) ? PUR1 : PUR2;
     pin %= 8; // Adjust pin number for 0-7 range
 
-    // Use SPI_Read to get the current GPIO Configuration Register value
-    uint8_t gpioConfigRegisterValue = SPI_Read(chipSelectPin, setReadMode(gpioConfigRegisterCommand));
+    bool isOutput = (mode == OUTPUT || mode == XRA1405_THREE_STATE);
+
+    // Get the current GPIO Configuration Register value (from the shadow cache when enabled)
+    uint8_t gpioConfigRegisterValue = readCachedRegister(gpioConfigRegisterCommand);
 
     // Modify the GPIO Configuration Register value based on mode
-    uint8_t newConfigValue = mode == OUTPUT ? (gpioConfigRegisterValue & ~(1 << pin)) : (gpioConfigRegisterValue | (1 << pin));
+    uint8_t newConfigValue = isOutput ? (gpioConfigRegisterValue & ~(1 << pin)) : (gpioConfigRegisterValue | (1 << pin));
 
-    // Use SPI_Write to write the modified value back
-    SPI_Write(chipSelectPin, setWriteMode(gpioConfigRegisterCommand), newConfigValue);
+    // Write the modified value back
+    writeCachedRegister(gpioConfigRegisterCommand, newConfigValue);
+
+    // Outputs drive unless three-state was asked for; inputs leave TSCR alone (it only affects outputs)
+    if (isOutput)
+    {
+        uint8_t threeStateRegisterValue = readCachedRegister(threeStateRegisterCommand);
+        uint8_t newThreeStateValue = mode == XRA1405_THREE_STATE ? (threeStateRegisterValue | (1 << pin)) : (threeStateRegisterValue & ~(1 << pin));
+        if (newThreeStateValue != threeStateRegisterValue)
+        {
+            writeCachedRegister(threeStateRegisterCommand, newThreeStateValue);
+        }
+    }
 
     // If mode is INPUT_PULLUP, enable the pull-up resistor
     if (mode == INPUT_PULLUP)
     {
-        uint8_t pullUpResistorRegisterCommand = (pin < 8) ? PUR1 : PUR2;
-        uint8_t pullUpResistorRegisterValue = SPI_Read(chipSelectPin, setReadMode(pullUpResistorRegisterCommand));
-        SPI_Write(chipSelectPin, setWriteMode(pullUpResistorRegisterCommand), pullUpResistorRegisterValue | (1 << pin));
+        uint8_t pullUpResistorRegisterValue = readCachedRegister(pullUpResistorRegisterCommand);
+        writeCachedRegister(pullUpResistorRegisterCommand, pullUpResistorRegisterValue | (1 << pin));
     }
 }
 
-void XRA1405_digitalWrite(uint8_t chipSelectPin, uint8_t pin, uint8_t value)
+void XRA1405::digitalWrite(uint8_t pin, uint8_t value)
 {
+    Lock lock(*this);
+
     uint8_t outputControlRegisterCommand = (pin < 8) ? OCR1 : OCR2;
     pin %= 8; // Adjust pin number for 0-7 range after determining the register
 
-    // Use SPI_Read to get the current state of the Output Control Register
-    uint8_t outputControlRegisterValue = SPI_Read(chipSelectPin, setReadMode(outputControlRegisterCommand));
+    // Get the current state of the Output Control Register (from the shadow cache when enabled)
+    uint8_t outputControlRegisterValue = readCachedRegister(outputControlRegisterCommand);
 
     // Modify the Output Control Register value based on the desired value
     uint8_t newOutputControlValue = value == HIGH ? (outputControlRegisterValue | (1 << pin)) : (outputControlRegisterValue & ~(1 << pin));
 
-    // Use SPI_Write to write the modified value back to the Output Control Register
-    SPI_Write(chipSelectPin, setWriteMode(outputControlRegisterCommand), newOutputControlValue);
+    // Write the modified value back to the Output Control Register
+    writeCachedRegister(outputControlRegisterCommand, newOutputControlValue);
 }
 
-uint8_t XRA1405_digitalRead(uint8_t chipSelectPin, uint8_t pin)
+uint8_t XRA1405::digitalRead(uint8_t pin)
 {
+    Lock lock(*this);
+
     uint8_t gpioStateRegisterCommand = (pin < 8) ? GSR1 : GSR2;
     pin %= 8; // Adjust pin number for 0-7 range after determining the register
 
-    // Use SPI_Read to perform the SPI transaction and read the state from the GPIO State Register
-    uint8_t gpioStateRegisterValue = SPI_Read(chipSelectPin, setReadMode(gpioStateRegisterCommand));
+    // With input gating, a pin that would have raised IRQ# on a change is answered from the last GSR value
+    uint16_t gpioState;
+    if (readGatedState(1 << (gpioStateRegisterCommand == GSR1 ? pin : pin + 8), gpioState))
+    {
+        return (gpioStateRegisterCommand == GSR1 ? gpioState >> pin : gpioState >> (pin + 8)) & 0x01;
+    }
+
+    // Read the state from the GPIO State Register (never cached, it reflects the pins)
+    transport().beginTransaction(_clock);
+    uint8_t gpioStateRegisterValue = readStateFrame(gpioStateRegisterCommand);
+    transport().endTransaction();
+    recordGpioState(gpioStateRegisterCommand == GSR1 ? gpioStateRegisterValue : (uint16_t)(gpioStateRegisterValue << 8),
+                    gpioStateRegisterCommand == GSR1 ? 0x00FF : 0xFF00);
 
     // Extract and return the state of the specified pin from the GSR value
     return (gpioStateRegisterValue >> pin) & 0x01; // Shift the GSR value right and mask with 0x01 to isolate the pin state
 }
 
-void XRA1405_setPullUp(uint8_t chipSelectPin, uint8_t pin, bool enabled)
+uint16_t XRA1405::readPort()
+{
+    Lock lock(*this);
+
+    uint16_t gpioState;
+    if (readGatedState(0xFFFF, gpioState))
+    {
+        return gpioState;
+    }
+
+    // GSR1 holds P0-P7 in the low byte, GSR2 holds P8-P15 in the high byte (never cached)
+    transport().beginTransaction(_clock);
+    gpioState = readStateFrame16();
+    transport().endTransaction();
+    recordGpioState(gpioState, 0xFFFF);
+    return gpioState;
+}
+
+void XRA1405::writePort(uint16_t value)
 {
+    Lock lock(*this);
+
+    writeCachedRegister16(OCR1, value);
+}
+
+void XRA1405::writePortMasked(uint16_t mask, uint16_t value)
+{
+    // Clear the masked bits, then flip the ones that should end up high
+    modifyPort(~mask, value & mask);
+}
+
+void XRA1405::setMask(uint16_t mask)
+{
+    modifyPort(~mask, mask);
+}
+
+void XRA1405::clearMask(uint16_t mask)
+{
+    modifyPort(~mask, 0);
+}
+
+void XRA1405::toggleMask(uint16_t mask)
+{
+    modifyPort(0xFFFF, mask);
+}
+
+void XRA1405::modifyPort(uint16_t andMask, uint16_t xorMask)
+{
+    // Bits that may change; a half of the port outside this set is left alone on the bus too
+    uint16_t touchedBits = ~andMask | xorMask;
+    if (touchedBits == 0)
+    {
+        return;
+    }
+
+    Lock lock(*this);
+
+    if ((touchedBits & 0xFF00) == 0)
+    {
+        // P0-P7 only: single OCR1 frame
+        uint8_t outputControlValue = readCachedRegister(OCR1);
+        writeCachedRegister(OCR1, (outputControlValue & andMask) ^ xorMask);
+    }
+    else if ((touchedBits & 0x00FF) == 0)
+    {
+        // P8-P15 only: single OCR2 frame
+        uint8_t outputControlValue = readCachedRegister(OCR2);
+        writeCachedRegister(OCR2, (outputControlValue & (andMask >> 8)) ^ (xorMask >> 8));
+    }
+    else
+    {
+        // Get the current outputs (from the shadow cache when enabled) and apply both masks in one paired write
+        uint16_t outputControlValue = readCachedRegister16(OCR1);
+        writeCachedRegister16(OCR1, (outputControlValue & andMask) ^ xorMask);
+    }
+}
+
+void XRA1405::setPullUp(uint8_t pin, bool enabled)
+{
+    Lock lock(*this);
+
     // Determine which Pull-Up Resistor Register (PUR) to use based on pin number
     uint8_t pullUpResistorRegisterCommand = (pin < 8) ? PUR1 : PUR2;
     pin %= 8; // Adjust pin number for 0-7 range
 
-    // Use SPI_Read to get the current state of the Pull-Up Resistor Register
-    uint8_t pullUpResistorRegisterValue = SPI_Read(chipSelectPin, setReadMode(pullUpResistorRegisterCommand));
+    // Get the current state of the Pull-Up Resistor Register (from the shadow cache when enabled)
+    uint8_t pullUpResistorRegisterValue = readCachedRegister(pullUpResistorRegisterCommand);
 
     // Modify the Pull-Up Resistor Register value based on whether the pull-up is enabled or not
     uint8_t newPullUpValue = enabled ? (pullUpResistorRegisterValue | (1 << pin)) : (pullUpResistorRegisterValue & ~(1 << pin));
 
-    // Use SPI_Write to write the modified value back to the Pull-Up Resistor Register
-    SPI_Write(chipSelectPin, setWriteMode(pullUpResistorRegisterCommand), newPullUpValue);
+    // Write the modified value back to the Pull-Up Resistor Register
+    writeCachedRegister(pullUpResistorRegisterCommand, newPullUpValue);
 }
 
-void XRA1405_setInterrupt(uint8_t chipSelectPin, uint8_t pin, XRA1405_InterruptType interruptType)
+void XRA1405::setInterrupt(uint8_t pin, XRA1405_InterruptType interruptType)
 {
+    Lock lock(*this);
+
+    // Configure edge detection first; it selects REIR/FEIR from the full 0-15 pin number
+    configureEdgeInterrupt(pin, interruptType);
+
     uint8_t interruptEnableRegisterCommand = (pin < 8) ? IER1 : IER2;
     pin %= 8; // Adjust pin number for 0-7 range
 
-    // Enable interrupt for the pin, regardless of edge detection, using SPI_Read and SPI_Write
-    uint8_t interruptEnableRegisterValue = SPI_Read(chipSelectPin, setReadMode(interruptEnableRegisterCommand));
-    interruptEnableRegisterValue |= (1 << pin);
-    SPI_Write(chipSelectPin, setWriteMode(interruptEnableRegisterCommand), interruptEnableRegisterValue);
+    // Enable the interrupt for the pin (both edges unless REIR/FEIR narrow it), or disable it
+    uint8_t interruptEnableRegisterValue = readCachedRegister(interruptEnableRegisterCommand);
+    if (interruptType == INTERRUPT_DISABLE)
+    {
+        interruptEnableRegisterValue &= ~(1 << pin);
+    }
+    else
+    {
+        interruptEnableRegisterValue |= (1 << pin);
+    }
+    writeCachedRegister(interruptEnableRegisterCommand, interruptEnableRegisterValue);
+}
 
-    // Configure edge detection based on the interruptType
-    configureEdgeInterrupt(chipSelectPin, pin, interruptType);
+void XRA1405::setInputPolarity(uint8_t pin, bool inverted)
+{
+    writeCachedPinBit(PIR1, pin, inverted);
 }
 
-void XRA1405_clearInterrupts(uint8_t chipSelectPin)
+void XRA1405::setInputPolarityPort(uint16_t invertedMask)
 {
-    uint8_t interruptStatusRegister1 = ISR1; // ISR1 for P0-P7
-    uint8_t interruptStatusRegister2 = ISR2; // ISR2 for P8-P15
+    writeRegister16(PIR1, invertedMask);
+}
 
-    // Clear interrupts for P0-P7 by reading the ISR1 register
-    SPI_Read(chipSelectPin, setReadMode(interruptStatusRegister1));
-    /// Note: Reading the interrupt status register typically clears the interrupt flags,
-    /// @todo so there's no need to write back. However, confirm this behavior with the XRA1405 datasheet.
+void XRA1405::setThreeState(uint8_t pin, bool enabled)
+{
+    writeCachedPinBit(TSCR1, pin, enabled);
+}
 
-    // Clear interrupts for P8-P15 by reading the ISR2 register
-    SPI_Read(chipSelectPin, setReadMode(interruptStatusRegister2));
-    // Similarly, reading ISR2 should clear the interrupt flags for these pins.
+void XRA1405::setThreeStatePort(uint16_t threeStateMask)
+{
+    writeRegister16(TSCR1, threeStateMask);
 }
 
-static uint8_t SPI_Read(uint8_t chipSelectPin, uint8_t commandByte)
+void XRA1405::setInputFilter(uint8_t pin, bool enabled)
 {
-    digitalWrite(chipSelectPin, LOW);
-    SPI.beginTransaction(SPISettings(XRA1405_SPI_CLOCK, SPI_ORDER, SPI_MODE));
-    SPI.transfer(commandByte);              // Send the command byte with read mode set
-    uint8_t readValue = SPI.transfer(0x00); // Clock out the read value
-    SPI.endTransaction();
-    digitalWrite(chipSelectPin, HIGH);
+    writeCachedPinBit(IFR1, pin, enabled);
+}
 
-    return readValue;
+void XRA1405::setInputFilterPort(uint16_t filterMask)
+{
+    writeRegister16(IFR1, filterMask);
 }
 
-static void SPI_Write(uint8_t chipSelectPin, uint8_t commandByte, uint8_t dataByte)
+uint8_t XRA1405::readRegister(XRA1405_Register registerCommand)
 {
-    digitalWrite(chipSelectPin, LOW);
-    SPI.beginTransaction(SPISettings(XRA1405_SPI_CLOCK, SPI_ORDER, SPI_MODE));
-    SPI.transfer(commandByte); // Send the command byte with write mode set
-    SPI.transfer(dataByte);    // Send the data byte
-    SPI.endTransaction();
-    digitalWrite(chipSelectPin, HIGH);
+    Lock lock(*this);
+
+    return SPI_Read(setReadMode(registerCommand));
 }
 
-static uint8_t setReadMode(uint8_t commandByte)
+void XRA1405::writeRegister(XRA1405_Register registerCommand, uint8_t value)
 {
-    // Set the MSB to 1 to indicate a read operation
-    return commandByte | XRA1405_READ;
+    Lock lock(*this);
+
+    writeCachedRegister(registerCommand, value);
 }
 
-static uint8_t setWriteMode(uint8_t commandByte)
+uint16_t XRA1405::readRegister16(XRA1405_Register registerCommand)
 {
-    // Ensure the MSB is 0 to indicate a write operation
-    return commandByte & XRA1405_WRITE;
+    Lock lock(*this);
+
+    transport().beginTransaction(_clock);
+    uint16_t value = readFrame16(registerCommand);
+    transport().endTransaction();
+
+    return value;
 }
 
-static void configureEdgeInterrupt(uint8_t chipSelectPin, uint8_t pin, XRA1405_InterruptType interruptType)
+void XRA1405::writeRegister16(XRA1405_Register registerCommand, uint16_t value)
 {
-    uint8_t risingEdgeRegisterCommand = (pin < 8) ? REIR1 : REIR2;
-    uint8_t fallingEdgeRegisterCommand = (pin < 8) ? FEIR1 : FEIR2;
-    pin %= 8; // Adjust pin number for 0-7 range
+    Lock lock(*this);
 
-    bool enableRising = (interruptType == INTERRUPT_RISING || interruptType == INTERRUPT_BOTH);
-    bool enableFalling = (interruptType == INTERRUPT_FALLING || interruptType == INTERRUPT_BOTH);
+    writeCachedRegister16(registerCommand, value);
+}
 
-    // Modify the Rising Edge Interrupt Register value
-    uint8_t risingInterruptRegisterValue = SPI_Read(chipSelectPin, setReadMode(risingEdgeRegisterCommand));
-    risingInterruptRegisterValue = enableRising ? (risingInterruptRegisterValue | (1 << pin)) : (risingInterruptRegisterValue & ~(1 << pin));
-    SPI_Write(chipSelectPin, setWriteMode(risingEdgeRegisterCommand), risingInterruptRegisterValue);
+uint16_t XRA1405::clearInterrupts()
+{
+    return readAndClearInterrupts();
+}
 
-    // Modify the Falling Edge Interrupt Register value
-    uint8_t fallingInterruptRegisterValue = SPI_Read(chipSelectPin, setReadMode(fallingEdgeRegisterCommand));
-    fallingInterruptRegisterValue = enableFalling ? (fallingInterruptRegisterValue | (1 << pin)) : (fallingInterruptRegisterValue & ~(1 << pin));
-    SPI_Write(chipSelectPin, setWriteMode(fallingEdgeRegisterCommand), fallingInterruptRegisterValue);
+uint16_t XRA1405::readAndClearInterrupts(uint16_t *state)
+{
+    Lock lock(*this);
 
-    // If interruptType is DISABLE, disable both edge interrupts
-    if (interruptType == INTERRUPT_DISABLE)
+    uint16_t gpioState;
+    uint16_t interruptStatus = readInterruptState(gpioState) | _latchedInterrupts;
+    _latchedInterrupts = 0;
+
+    if (state != nullptr)
+    {
+        *state = gpioState;
+    }
+    return interruptStatus;
+}
+
+uint16_t XRA1405::readInterruptState(uint16_t &state)
+{
+    transport().beginTransaction(_clock);
+
+    // ISR1/ISR2 report which pins fired; reading them does not clear anything
+    uint16_t interruptStatus = readFrame16(ISR1);
+
+    // Reading GSR1/GSR2 is what clears the interrupt (datasheet Table 3)
+    state = readFrame16(GSR1);
+
+    transport().endTransaction();
+
+    recordGpioState(state, 0xFFFF);
+    return interruptStatus;
+}
+
+uint8_t XRA1405::readStateFrame(uint8_t registerCommand)
+{
+    uint8_t half = registerCommand == GSR1 ? 0 : 1;
+    if (interruptsInUse())
+    {
+        uint8_t interruptFrame[2] = {setReadMode(ISR1 + (half << 1)), 0x00};
+        transferFrame(interruptFrame, 2);
+        latchInterrupts((uint16_t)(interruptFrame[1] << (half * 8)));
+    }
+
+#if XRA1405_ENABLE_STATS
+    _stats.cacheMisses++;
+#endif
+    uint8_t stateFrame[2] = {setReadMode(registerCommand), 0x00};
+    transferFrame(stateFrame, 2);
+    return stateFrame[1];
+}
+
+uint16_t XRA1405::readStateFrame16()
+{
+    if (interruptsInUse())
+    {
+        latchInterrupts(readFrame16(ISR1));
+    }
+#if XRA1405_ENABLE_STATS
+    _stats.cacheMisses += 2;
+#endif
+    return readFrame16(GSR1);
+}
+
+void XRA1405::latchInterrupts(uint16_t interruptStatus)
+{
+    if (interruptStatus == 0)
+    {
+        return;
+    }
+    _latchedInterrupts |= interruptStatus;
+    if (_irqPin != XRA1405_NO_PIN)
     {
-        SPI_Write(chipSelectPin, setWriteMode(risingEdgeRegisterCommand), risingInterruptRegisterValue & ~(1 << pin));
-        SPI_Write(chipSelectPin, setWriteMode(fallingEdgeRegisterCommand), fallingInterruptRegisterValue & ~(1 << pin));
+        _irqPending = true;
     }
-}
\ No newline at end of file
+}
+
+void XRA1405::setInputGating(bool enabled)
+{
+    Lock lock(*this);
+
+    _inputGating = enabled;
+    _gpioStateKnown = 0; // Start from a fresh GSR read
+}
+
+bool XRA1405::readGatedState(uint16_t pins, uint16_t &state)
+{
+    if (!_inputGating || !_cacheEnabled || _irqPin == XRA1405_NO_PIN)
+    {
+        return false;
+    }
+
+    // Pins that cannot change without IRQ# asserting: outputs (GSR mirrors OCR) and inputs with
+    // IER set and REIR/FEIR both or neither set, i.e. interrupting on both edges (datasheet Table 3)
+    uint16_t inputs = readCachedRegister16(GCR1);
+    uint16_t edges = readCachedRegister16(REIR1) ^ readCachedRegister16(FEIR1);
+    uint16_t covered = ~inputs | (inputs & readCachedRegister16(IER1) & ~edges);
+    if ((pins & covered) != pins)
+    {
+        return false;
+    }
+
+    // Something changed: take the new state now and keep the interrupt bits for serviceInterrupts()
+    if (_gpioStateStale || ::digitalRead(_irqPin) == LOW)
+    {
+        uint16_t gpioState;
+        _gpioStateStale = false;
+        latchInterrupts(readInterruptState(gpioState));
+    }
+
+    if ((pins & inputs & _gpioStateKnown) != (pins & inputs))
+    {
+        return false;
+    }
+
+    state = (_gpioState & inputs) | (readCachedRegister16(OCR1) & ~inputs);
+    return true;
+}
+
+void XRA1405::recordGpioState(uint16_t state, uint16_t knownMask)
+{
+    _gpioState = (_gpioState & ~knownMask) | (state & knownMask);
+    _gpioStateKnown |= knownMask;
+}
+
+void XRA1405::attachInterrupt(uint8_t irqPin, XRA1405_ChangeCallback callback, void *context)
+{
+    detachInterrupt();
+
+    _changeCallback = callback;
+    _changeContext = context;
+    _irqPin = irqPin;
+
+    // IRQ# is open-drain and active low; a level that is already low means an event is waiting
+    ::pinMode(_irqPin, INPUT_PULLUP);
+    _irqPending = ::digitalRead(_irqPin) == LOW;
+    _irqMicros = micros();
+    attachIrqHandler();
+}
+
+void XRA1405::detachInterrupt()
+{
+    if (_irqPin != XRA1405_NO_PIN)
+    {
+        detachIrqHandler();
+        _irqPin = XRA1405_NO_PIN;
+    }
+    _irqPending = false;
+}
+
+#if XRA1405_INTERRUPT_ARG
+void XRA1405::attachIrqHandler()
+{
+    attachInterruptArg(digitalPinToInterrupt(_irqPin), handleIrq, this, FALLING);
+}
+
+void XRA1405::detachIrqHandler()
+{
+    ::detachInterrupt(digitalPinToInterrupt(_irqPin));
+}
+#else
+static_assert(XRA1405_MAX_IRQ_DEVICES <= 8, "XRA1405_MAX_IRQ_DEVICES supports up to 8 trampolines");
+
+// The ISR of trampoline slot i finds its device here
+static XRA1405 *volatile irqDevices[XRA1405_MAX_IRQ_DEVICES];
+
+template <uint8_t Slot>
+void IRAM_ATTR XRA1405::irqTrampoline()
+{
+    handleIrq(irqDevices[Slot]);
+}
+
+void XRA1405::attachIrqHandler()
+{
+    static void (*const trampolines[8])() = {irqTrampoline<0>, irqTrampoline<1>, irqTrampoline<2>, irqTrampoline<3>,
+                                             irqTrampoline<4>, irqTrampoline<5>, irqTrampoline<6>, irqTrampoline<7>};
+
+    noInterrupts();
+    _irqSlot = XRA1405_NO_PIN;
+    for (uint8_t i = 0; i < XRA1405_MAX_IRQ_DEVICES; i++)
+    {
+        if (irqDevices[i] == nullptr)
+        {
+            irqDevices[i] = this;
+            _irqSlot = i;
+            break;
+        }
+    }
+    interrupts();
+
+    if (_irqSlot != XRA1405_NO_PIN)
+    {
+        ::attachInterrupt(digitalPinToInterrupt(_irqPin), trampolines[_irqSlot], FALLING);
+    }
+}
+
+void XRA1405::detachIrqHandler()
+{
+    if (_irqSlot == XRA1405_NO_PIN)
+    {
+        return;
+    }
+
+    ::detachInterrupt(digitalPinToInterrupt(_irqPin));
+    irqDevices[_irqSlot] = nullptr;
+    _irqSlot = XRA1405_NO_PIN;
+}
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool XRA1405::prepareSleep(uint16_t wakePins, XRA1405_InterruptType edges)
+{
+    Lock lock(*this);
+
+    if (_irqPin == XRA1405_NO_PIN)
+    {
+        return false;
+    }
+
+    _awakeInterrupts[0] = readCachedRegister16(IER1);
+    _awakeInterrupts[1] = readCachedRegister16(REIR1);
+    _awakeInterrupts[2] = readCachedRegister16(FEIR1);
+
+    // Other pins lose IER so they cannot wake the host
+    bool rising = edges == INTERRUPT_RISING || edges == INTERRUPT_BOTH;
+    bool falling = edges == INTERRUPT_FALLING || edges == INTERRUPT_BOTH;
+    uint16_t risingEdges = rising ? (_awakeInterrupts[1] | wakePins) : (_awakeInterrupts[1] & ~wakePins);
+    uint16_t fallingEdges = falling ? (_awakeInterrupts[2] | wakePins) : (_awakeInterrupts[2] & ~wakePins);
+    writeInterruptSetup(edges == INTERRUPT_DISABLE ? 0 : wakePins, risingEdges, fallingEdges);
+
+    // Release IRQ#, keeping what was pending for resume()
+    uint16_t gpioState;
+    _latchedInterrupts |= readInterruptState(gpioState);
+    if (::digitalRead(_irqPin) == LOW)
+    {
+        return false;
+    }
+
+    // The wake source reprograms the pin's interrupt type, so the edge ISR has to go while asleep
+    detachIrqHandler();
+    gpio_wakeup_enable((gpio_num_t)_irqPin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    return true;
+}
+
+uint16_t XRA1405::resume(uint16_t *state)
+{
+    Lock lock(*this);
+
+    if (_irqPin == XRA1405_NO_PIN)
+    {
+        return 0;
+    }
+
+    // Capture what woke us before spending any time on reconfiguration
+    uint16_t woke = readAndClearInterrupts(state);
+
+    gpio_wakeup_disable((gpio_num_t)_irqPin);
+    attachIrqHandler();
+    _irqPending = ::digitalRead(_irqPin) == LOW;
+    _irqMicros = micros();
+    _gpioStateStale = _irqPending;
+
+    writeInterruptSetup(_awakeInterrupts[0], _awakeInterrupts[1], _awakeInterrupts[2]);
+    return woke;
+}
+
+void XRA1405::writeInterruptSetup(uint16_t enabled, uint16_t risingEdges, uint16_t fallingEdges)
+{
+    // Edges before IER, like configure(), so no pin interrupts on a stale edge selection
+    const uint8_t registers[3] = {REIR1, FEIR1, IER1};
+    const uint16_t values[3] = {risingEdges, fallingEdges, enabled};
+
+    XRA1405_Batch batch(*this);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (!_cacheEnabled || readCachedRegister16(registers[i]) != values[i])
+        {
+            batch.write16(registers[i], values[i]);
+        }
+    }
+    batch.commit();
+}
+#endif
+
+uint16_t XRA1405::serviceInterrupts()
+{
+    Lock lock(*this);
+
+#if !XRA1405_INTERRUPT_ARG
+    // No trampoline was free, so no ISR sets _irqPending: poll the IRQ# level instead
+    if (_irqSlot == XRA1405_NO_PIN && _irqPin != XRA1405_NO_PIN && ::digitalRead(_irqPin) == LOW)
+    {
+        _irqPending = true;
+    }
+#endif
+
+    if (!_irqPending)
+    {
+        return 0;
+    }
+    _irqPending = false;
+
+    uint16_t state;
+    uint16_t changedMask = readAndClearInterrupts(&state);
+
+    if (changedMask != 0 && _changeCallback != nullptr)
+    {
+        _changeCallback(*this, changedMask, state, _changeContext);
+    }
+
+    // An edge between the two reads keeps IRQ# low without a new falling edge, service it next time.
+    // Checked after the callback so interruptMicros() still belonged to this event inside it.
+    if (::digitalRead(_irqPin) == LOW)
+    {
+        _irqMicros = micros();
+        _irqPending = true;
+    }
+
+    return changedMask;
+}
+
+void IRAM_ATTR XRA1405::handleIrq(void *device)
+{
+    XRA1405 *self = static_cast<XRA1405 *>(device);
+    if (!self->_irqPending)
+    {
+        self->_irqMicros = micros(); // First edge of the event that is about to be serviced
+    }
+    self->_irqPending = true;
+    self->_gpioStateStale = true;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (self->_notifyTask != nullptr)
+    {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(self->_notifyTask, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken == pdTRUE)
+        {
+            portYIELD_FROM_ISR();
+        }
+    }
+#endif
+}
+
+void XRA1405::enableCache()
+{
+    _cacheEnabled = true;
+    resyncCache();
+}
+
+void XRA1405::disableCache()
+{
+    _cacheEnabled = false;
+}
+
+bool XRA1405::resyncCache()
+{
+    Lock lock(*this);
+
+    if (!_cacheEnabled)
+    {
+        return false;
+    }
+
+    // Populate every writable register from the chip in one transaction. GSR/ISR are skipped,
+    // reading GSR clears pending interrupts.
+    XRA1405_RegisterMap map;
+    dumpRegisters(map, false);
+
+    const uint8_t *registerValues = reinterpret_cast<const uint8_t *>(&map);
+    for (uint8_t address = 0; address < XRA1405_REGISTER_COUNT; address++)
+    {
+        if (isCacheableRegister(address << 1))
+        {
+            _shadowRegisters[address] = registerValues[address];
+        }
+    }
+
+    return true;
+}
+
+void XRA1405::dumpRegisters(XRA1405_RegisterMap &map, bool readState)
+{
+    Lock lock(*this);
+
+    uint8_t *registerValues = reinterpret_cast<uint8_t *>(&map);
+    uint16_t interruptStatus = 0;
+    uint16_t gpioState = 0;
+
+    transport().beginTransaction(_clock);
+
+    if (readState)
+    {
+        // ISR first, the GSR read that follows is what clears it (datasheet Table 3)
+        interruptStatus = readFrame16(ISR1);
+        gpioState = readFrame16(GSR1);
+    }
+
+    // The chip alternates between the two registers of a pair within a frame, not across pairs,
+    // so one paired frame per pair is the widest burst it supports
+    for (uint8_t address = 0; address < XRA1405_REGISTER_COUNT; address += 2)
+    {
+        uint8_t registerCommand = address << 1;
+        if (isCacheableRegister(registerCommand))
+        {
+            uint16_t value = readFrame16(registerCommand);
+            registerValues[address] = value & 0xFF;
+            registerValues[address + 1] = value >> 8;
+        }
+    }
+
+    transport().endTransaction();
+
+    map.isr1 = interruptStatus & 0xFF;
+    map.isr2 = interruptStatus >> 8;
+    map.gsr1 = gpioState & 0xFF;
+    map.gsr2 = gpioState >> 8;
+    _interruptEnable = (uint16_t)(map.ier2 << 8) | map.ier1;
+
+    if (readState)
+    {
+        // The GSR read acknowledged these on the chip; they still belong to serviceInterrupts()
+        latchInterrupts(interruptStatus);
+        recordGpioState(gpioState, 0xFFFF);
+    }
+}
+
+void XRA1405::restoreRegisters(const XRA1405_RegisterMap &map)
+{
+    XRA1405_Config config = {
+        (uint16_t)(map.ocr2 << 8 | map.ocr1), (uint16_t)(map.pir2 << 8 | map.pir1),
+        (uint16_t)(map.gcr2 << 8 | map.gcr1), (uint16_t)(map.pur2 << 8 | map.pur1),
+        (uint16_t)(map.ier2 << 8 | map.ier1), (uint16_t)(map.tscr2 << 8 | map.tscr1),
+        (uint16_t)(map.reir2 << 8 | map.reir1), (uint16_t)(map.feir2 << 8 | map.feir1),
+        (uint16_t)(map.ifr2 << 8 | map.ifr1)};
+
+    // Same frames and order as configure(), so pins never pass through a mixed state
+    configure(config);
+}
+
+// Register pairs repairRegisters() can check, in the order configure() writes them
+static const uint8_t repairRegisterOrder[] = {OCR1, TSCR1, PIR1, PUR1, IFR1, REIR1, FEIR1, GCR1, IER1};
+static const uint8_t repairRegisterCount = sizeof(repairRegisterOrder);
+
+uint8_t XRA1405::repairRegisters(uint16_t pairs)
+{
+    Lock lock(*this);
+
+    if (!_cacheEnabled)
+    {
+        return 0;
+    }
+
+    // One paired read per selected pair, all in one transaction
+    uint16_t chipValues[repairRegisterCount];
+    transport().beginTransaction(_clock);
+    for (uint8_t i = 0; i < repairRegisterCount; i++)
+    {
+        if (pairs & XRA1405_CHECK_PAIR(repairRegisterOrder[i]))
+        {
+            chipValues[i] = readFrame16(repairRegisterOrder[i]);
+        }
+    }
+    transport().endTransaction();
+
+    // Rewrite whichever half of a pair drifted, or the whole pair in one frame if both did
+    XRA1405_Batch batch(*this);
+    uint8_t repaired = 0;
+    for (uint8_t i = 0; i < repairRegisterCount; i++)
+    {
+        uint8_t registerCommand = repairRegisterOrder[i];
+        if (!(pairs & XRA1405_CHECK_PAIR(registerCommand)))
+        {
+            continue;
+        }
+
+        uint8_t address = registerCommand >> 1;
+        uint16_t expected = (uint16_t)(_shadowRegisters[address + 1] << 8) | _shadowRegisters[address];
+        uint16_t difference = chipValues[i] ^ expected;
+        if ((difference & 0x00FF) && (difference & 0xFF00))
+        {
+            batch.write16(registerCommand, expected);
+            repaired += 2;
+        }
+        else if (difference & 0x00FF)
+        {
+            batch.write(registerCommand, expected & 0xFF);
+            repaired++;
+        }
+        else if (difference & 0xFF00)
+        {
+            batch.write(registerCommand + (1 << 1), expected >> 8);
+            repaired++;
+        }
+    }
+    batch.commit();
+
+    return repaired;
+}
+
+#if XRA1405_THREAD_SAFE
+// One recursive mutex per SPI bus, created the first time a device on that bus takes it
+struct XRA1405_BusMutex
+{
+    const void *bus; // XRA1405_Transport::busKey()
+    SemaphoreHandle_t mutex;
+};
+
+static XRA1405_BusMutex busMutexes[XRA1405_MAX_BUSES];
+static portMUX_TYPE busMutexesLock = portMUX_INITIALIZER_UNLOCKED;
+
+static SemaphoreHandle_t findBusMutex(const void *bus)
+{
+    for (uint8_t i = 0; i < XRA1405_MAX_BUSES; i++)
+    {
+        if (busMutexes[i].bus == bus)
+        {
+            return busMutexes[i].mutex;
+        }
+    }
+    return nullptr;
+}
+
+static SemaphoreHandle_t busMutex(const void *bus)
+{
+    portENTER_CRITICAL(&busMutexesLock);
+    SemaphoreHandle_t mutex = findBusMutex(bus);
+    portEXIT_CRITICAL(&busMutexesLock);
+    if (mutex != nullptr)
+    {
+        return mutex;
+    }
+
+    // Allocate outside the critical section, then publish unless another task got there first
+    SemaphoreHandle_t created = xSemaphoreCreateRecursiveMutex();
+    portENTER_CRITICAL(&busMutexesLock);
+    mutex = findBusMutex(bus);
+    if (mutex == nullptr)
+    {
+        for (uint8_t i = 0; i < XRA1405_MAX_BUSES; i++)
+        {
+            if (busMutexes[i].bus == nullptr)
+            {
+                busMutexes[i].bus = bus;
+                busMutexes[i].mutex = created;
+                mutex = created;
+                break;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&busMutexesLock);
+
+    if (mutex != created)
+    {
+        vSemaphoreDelete(created);
+    }
+    return mutex; // nullptr once XRA1405_MAX_BUSES buses are registered: no locking for the rest
+}
+
+XRA1405::Lock::Lock(XRA1405 &device)
+    : _mutex(nullptr)
+{
+    if (!device._locking)
+    {
+        return;
+    }
+    if (device._busMutex == nullptr)
+    {
+        device._busMutex = busMutex(device.transport().busKey());
+    }
+    _mutex = device._busMutex;
+    if (_mutex != nullptr)
+    {
+        xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+    }
+}
+
+XRA1405::Lock::~Lock()
+{
+    if (_mutex != nullptr)
+    {
+        xSemaphoreGiveRecursive(_mutex);
+    }
+}
+#endif
+
+XRA1405_Batch XRA1405::beginBatch()
+{
+    return XRA1405_Batch(*this);
+}
+
+void XRA1405::configure(const XRA1405_Config &config)
+{
+    Lock lock(*this);
+
+    transport().beginTransaction(_clock);
+    writeConfigFrames(config);
+    transport().endTransaction();
+}
+
+// Register pairs exercised by the self-test; the first ones leave the pins alone while IER is off
+static const uint8_t selfTestRegisters[] = {PIR1, REIR1, FEIR1, IFR1, OCR1, TSCR1, PUR1, GCR1, IER1};
+static const uint8_t selfTestSafeRegisterCount = 4;
+
+// Each pattern is applied with its complement, and salted per register to catch address aliasing
+static const uint16_t selfTestPatterns[] = {0x0000, 0xFFFF, 0x5555, 0xAAAA};
+
+// Clocks tried by qualifyClock() below maxClock(), fastest first
+static const uint32_t qualifyClocks[] = {26000000, 20000000, 16000000, 13000000, 10000000, 8000000,
+                                         5000000, 4000000, 2000000, 1000000, 500000, 100000};
+
+bool XRA1405::selfTest(XRA1405_SelfTestResult &result, bool allRegisters)
+{
+    Lock lock(*this);
+
+    uint8_t registerCount = allRegisters ? sizeof(selfTestRegisters) : selfTestSafeRegisterCount;
+    uint16_t originalValues[sizeof(selfTestRegisters)];
+
+    readSelfTestOriginals(originalValues, registerCount);
+    bool passed = runSelfTestPatterns(result, registerCount);
+
+    // A clock that just failed cannot be trusted to put the originals back
+    writeSelfTestValues(originalValues, registerCount, passed ? _clock : _minClock);
+    return passed;
+}
+
+bool XRA1405::qualifyClock(XRA1405_SelfTestResult &result, bool allRegisters)
+{
+    Lock lock(*this);
+
+    uint8_t registerCount = allRegisters ? sizeof(selfTestRegisters) : selfTestSafeRegisterCount;
+    uint16_t originalValues[sizeof(selfTestRegisters)];
+    uint32_t originalClock = _clock;
+    XRA1405_SelfTestResult firstFailure = {true, GSR1, 0, 0, 0, 0};
+
+    // Taken once before the sweep, so a failing clock never gets to corrupt them
+    readSelfTestOriginals(originalValues, registerCount);
+
+    // maxClock() first, then the table entries below it, down to minClock()
+    result.maxClock = 0;
+    for (int8_t i = -1; i < (int8_t)(sizeof(qualifyClocks) / sizeof(qualifyClocks[0])); i++)
+    {
+        uint32_t clock = (i < 0) ? _maxClock : qualifyClocks[i];
+        if ((i >= 0 && clock >= _maxClock) || clock < _minClock)
+        {
+            continue;
+        }
+
+        _clock = clock;
+        if (runSelfTestPatterns(result, registerCount))
+        {
+            result.maxClock = clock;
+            break;
+        }
+        if (firstFailure.passed)
+        {
+            firstFailure = result;
+        }
+    }
+
+    // Restore once, at the qualified clock, or at the slowest one if none passed
+    writeSelfTestValues(originalValues, registerCount, result.maxClock != 0 ? result.maxClock : _minClock);
+    _clock = originalClock;
+
+    // Report the failure seen at the fastest clock, it shows what broke first
+    if (result.maxClock == 0 && !firstFailure.passed)
+    {
+        result = firstFailure;
+        result.maxClock = 0;
+    }
+    return result.maxClock != 0;
+}
+
+void XRA1405::readSelfTestOriginals(uint16_t *values, uint8_t registerCount)
+{
+    // The shadow cache holds them already; otherwise read at the slowest clock, which any wiring passes
+    if (_cacheEnabled)
+    {
+        for (uint8_t i = 0; i < registerCount; i++)
+        {
+            uint8_t address = selfTestRegisters[i] >> 1;
+            values[i] = (uint16_t)(_shadowRegisters[address + 1] << 8) | _shadowRegisters[address];
+        }
+        return;
+    }
+
+    transport().beginTransaction(_minClock);
+    for (uint8_t i = 0; i < registerCount; i++)
+    {
+        values[i] = readFrame16(selfTestRegisters[i]);
+    }
+    transport().endTransaction();
+}
+
+bool XRA1405::runSelfTestPatterns(XRA1405_SelfTestResult &result, uint8_t registerCount)
+{
+    result.passed = true;
+    result.failedRegister = GSR1;
+    result.expected = 0;
+    result.actual = 0;
+    result.errorBits = 0;
+
+    for (uint8_t p = 0; p < sizeof(selfTestPatterns) / sizeof(selfTestPatterns[0]); p++)
+    {
+        // Write every pair, then read every pair back, so each phase is one burst on the bus
+        transport().beginTransaction(_clock);
+        for (uint8_t i = 0; i < registerCount; i++)
+        {
+            uint16_t salt = (uint16_t)selfTestRegisters[i] * 0x0101;
+            writeFrame16(selfTestRegisters[i], selfTestPatterns[p] ^ salt);
+        }
+        transport().endTransaction();
+
+        transport().beginTransaction(_clock);
+        for (uint8_t i = 0; i < registerCount; i++)
+        {
+            uint16_t salt = (uint16_t)selfTestRegisters[i] * 0x0101;
+            uint16_t expected = selfTestPatterns[p] ^ salt;
+            uint16_t actual = readFrame16(selfTestRegisters[i]);
+            if (actual != expected)
+            {
+                if (result.passed)
+                {
+                    result.passed = false;
+                    result.failedRegister = selfTestRegisters[i];
+                    result.expected = expected;
+                    result.actual = actual;
+                }
+                result.errorBits |= actual ^ expected;
+            }
+        }
+        transport().endTransaction();
+    }
+
+    return result.passed;
+}
+
+void XRA1405::writeSelfTestValues(const uint16_t *values, uint8_t registerCount, uint32_t clock)
+{
+    // Also brings the shadow cache in line with them
+    transport().beginTransaction(clock);
+    for (uint8_t i = 0; i < registerCount; i++)
+    {
+        writeFrame16(selfTestRegisters[i], values[i]);
+    }
+    transport().endTransaction();
+}
+
+uint8_t XRA1405::SPI_Read(uint8_t commandByte)
+{
+    uint8_t buffer[2] = {commandByte, 0x00}; // Command byte with read mode set, then clock out the value
+
+    transport().beginTransaction(_clock);
+    transferFrame(buffer, 2);
+    transport().endTransaction();
+
+    return buffer[1];
+}
+
+void XRA1405::SPI_Write(uint8_t commandByte, uint8_t dataByte)
+{
+    uint8_t buffer[2] = {commandByte, dataByte}; // Command byte with write mode set, then the data byte
+
+    transport().beginTransaction(_clock);
+    transferFrame(buffer, 2);
+    transport().endTransaction();
+}
+
+void XRA1405::transferFrame(uint8_t *data, uint8_t length)
+{
+#if XRA1405_ENABLE_STATS
+    uint8_t commandByte = data[0]; // The transfer overwrites the buffer
+    uint32_t startTicks = statsTicks();
+#endif
+    transport().transfer(data, length);
+#if XRA1405_ENABLE_STATS
+    recordFrame(commandByte, length, statsTicks() - startTicks);
+#endif
+}
+
+#if XRA1405_ENABLE_STATS
+void XRA1405::recordFrame(uint8_t commandByte, uint8_t length, uint32_t ticks)
+{
+    _stats.frames++;
+    _stats.bytes += length;
+
+    // Data bytes after the command alternate between the two registers of the pair
+    uint32_t *counters = (commandByte & XRA1405_READ) ? _stats.reads : _stats.writes;
+    uint8_t address = (commandByte >> 1) & 0x3F;
+    for (uint8_t i = 1; i < length; i++)
+    {
+        uint8_t registerAddress = (i & 1) ? address : (address ^ 1);
+        if (registerAddress < XRA1405_REGISTER_COUNT)
+        {
+            counters[registerAddress]++;
+        }
+    }
+
+    // Bucket n holds durations of [2^n, 2^(n+1)) ticks
+    uint8_t bucket = 0;
+    while ((ticks >> 1) != 0 && bucket < XRA1405_STATS_BUCKETS - 1)
+    {
+        ticks >>= 1;
+        bucket++;
+    }
+    _stats.latency[bucket]++;
+}
+
+void XRA1405::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+#endif
+
+uint16_t XRA1405::readFrame16(uint8_t registerCommand)
+{
+#if XRA1405_PAIRED_ACCESS
+    uint8_t buffer[3] = {setReadMode(registerCommand), 0x00, 0x00};
+    transferFrame(buffer, 3);
+    return (uint16_t)(buffer[2] << 8) | buffer[1];
+#else
+    uint8_t lowBuffer[2] = {setReadMode(registerCommand), 0x00};
+    uint8_t highBuffer[2] = {setReadMode(registerCommand + (1 << 1)), 0x00};
+    transferFrame(lowBuffer, 2);
+    transferFrame(highBuffer, 2);
+    return (uint16_t)(highBuffer[1] << 8) | lowBuffer[1];
+#endif
+}
+
+void XRA1405::writeFrame16(uint8_t registerCommand, uint16_t value)
+{
+#if XRA1405_PAIRED_ACCESS
+    uint8_t buffer[3] = {setWriteMode(registerCommand), (uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+    transferFrame(buffer, 3);
+#else
+    uint8_t lowBuffer[2] = {setWriteMode(registerCommand), (uint8_t)(value & 0xFF)};
+    uint8_t highBuffer[2] = {setWriteMode(registerCommand + (1 << 1)), (uint8_t)(value >> 8)};
+    transferFrame(lowBuffer, 2);
+    transferFrame(highBuffer, 2);
+#endif
+    updateShadow(registerCommand, value & 0xFF);
+    updateShadow(registerCommand + (1 << 1), value >> 8);
+}
+
+void XRA1405::writeConfigFrames(const XRA1405_Config &config)
+{
+    // Output levels and modifiers first so pins come up in their final state when GCR switches them,
+    // interrupts are enabled last once the edges are set
+    writeFrame16(OCR1, config.ocr);
+    writeFrame16(TSCR1, config.tscr);
+    writeFrame16(PIR1, config.pir);
+    writeFrame16(PUR1, config.pur);
+    writeFrame16(IFR1, config.ifr);
+    writeFrame16(REIR1, config.reir);
+    writeFrame16(FEIR1, config.feir);
+    writeFrame16(GCR1, config.gcr);
+    writeFrame16(IER1, config.ier);
+}
+
+void XRA1405::updateShadow(uint8_t registerCommand, uint8_t value)
+{
+    // Polarity, direction and interrupt setup change what GSR reports or which pins raise IRQ#,
+    // so the gated GSR snapshot of that half of the port is no longer trustworthy
+    uint8_t pairAddress = (registerCommand >> 1) & ~1;
+    if (pairAddress == (PIR1 >> 1) || pairAddress == (GCR1 >> 1) || pairAddress == (IER1 >> 1) ||
+        pairAddress == (REIR1 >> 1) || pairAddress == (FEIR1 >> 1))
+    {
+        _gpioStateKnown &= ((registerCommand >> 1) & 1) ? 0x00FF : 0xFF00;
+    }
+
+    if (pairAddress == (IER1 >> 1))
+    {
+        uint8_t shift = ((registerCommand >> 1) & 1) * 8;
+        _interruptEnable = (uint16_t)((_interruptEnable & ~(0xFF << shift)) | (value << shift));
+    }
+
+    if (_cacheEnabled && isCacheableRegister(registerCommand))
+    {
+        _shadowRegisters[registerCommand >> 1] = value;
+    }
+}
+
+uint8_t XRA1405::readCachedRegister(uint8_t registerCommand)
+{
+    if (_cacheEnabled && isCacheableRegister(registerCommand))
+    {
+#if XRA1405_ENABLE_STATS
+        _stats.cacheHits++;
+#endif
+        return _shadowRegisters[registerCommand >> 1]; // Skip the bus, the shadow holds what we last wrote
+    }
+
+#if XRA1405_ENABLE_STATS
+    _stats.cacheMisses++;
+#endif
+    return SPI_Read(setReadMode(registerCommand));
+}
+
+void XRA1405::writeCachedRegister(uint8_t registerCommand, uint8_t value)
+{
+    SPI_Write(setWriteMode(registerCommand), value);
+    updateShadow(registerCommand, value);
+}
+
+uint16_t XRA1405::readCachedRegister16(uint8_t registerCommand)
+{
+    if (_cacheEnabled && isCacheableRegister(registerCommand))
+    {
+        return readCachedFrame16(registerCommand); // Served from the shadow, no transaction needed
+    }
+
+    transport().beginTransaction(_clock);
+    uint16_t value = readCachedFrame16(registerCommand);
+    transport().endTransaction();
+
+    return value;
+}
+
+uint16_t XRA1405::readCachedFrame16(uint8_t registerCommand)
+{
+    if (_cacheEnabled && isCacheableRegister(registerCommand))
+    {
+#if XRA1405_ENABLE_STATS
+        _stats.cacheHits += 2;
+#endif
+        uint8_t address = registerCommand >> 1;
+        return (uint16_t)(_shadowRegisters[address + 1] << 8) | _shadowRegisters[address];
+    }
+
+#if XRA1405_ENABLE_STATS
+    _stats.cacheMisses += 2;
+#endif
+    return readFrame16(registerCommand);
+}
+
+void XRA1405::writeCachedRegister16(uint8_t registerCommand, uint16_t value)
+{
+    transport().beginTransaction(_clock);
+    writeFrame16(registerCommand, value); // Also updates the shadow cache
+    transport().endTransaction();
+}
+
+void XRA1405::writeCachedPinBit(uint8_t lowRegister, uint8_t pin, bool value)
+{
+    Lock lock(*this);
+
+    // The P8-P15 register of a pair sits at the next address
+    uint8_t registerCommand = (pin < 8) ? lowRegister : (uint8_t)(lowRegister + (1 << 1));
+    pin %= 8; // Adjust pin number for 0-7 range
+
+    uint8_t registerValue = readCachedRegister(registerCommand);
+    writeCachedRegister(registerCommand, value ? (registerValue | (1 << pin)) : (registerValue & ~(1 << pin)));
+}
+
+void XRA1405::configureEdgeInterrupt(uint8_t pin, XRA1405_InterruptType interruptType)
+{
+    uint8_t risingEdgeRegisterCommand = (pin < 8) ? REIR1 : REIR2;
+    uint8_t fallingEdgeRegisterCommand = (pin < 8) ? FEIR1 : FEIR2;
+    pin %= 8; // Adjust pin number for 0-7 range
+
+    bool enableRising = (interruptType == INTERRUPT_RISING || interruptType == INTERRUPT_BOTH);
+    bool enableFalling = (interruptType == INTERRUPT_FALLING || interruptType == INTERRUPT_BOTH);
+
+    // Modify the Rising Edge Interrupt Register value
+    uint8_t risingInterruptRegisterValue = readCachedRegister(risingEdgeRegisterCommand);
+    risingInterruptRegisterValue = enableRising ? (risingInterruptRegisterValue | (1 << pin)) : (risingInterruptRegisterValue & ~(1 << pin));
+    writeCachedRegister(risingEdgeRegisterCommand, risingInterruptRegisterValue);
+
+    // Modify the Falling Edge Interrupt Register value
+    uint8_t fallingInterruptRegisterValue = readCachedRegister(fallingEdgeRegisterCommand);
+    fallingInterruptRegisterValue = enableFalling ? (fallingInterruptRegisterValue | (1 << pin)) : (fallingInterruptRegisterValue & ~(1 << pin));
+    writeCachedRegister(fallingEdgeRegisterCommand, fallingInterruptRegisterValue);
+}
+
+XRA1405_Batch::XRA1405_Batch(XRA1405 &device)
+    : _device(&device),
+      _count(0)
+{
+}
+
+void XRA1405_Batch::write(uint8_t registerCommand, uint8_t value)
+{
+    queue(registerCommand, 1, value);
+}
+
+void XRA1405_Batch::write16(uint8_t registerCommand, uint16_t value)
+{
+#if XRA1405_PAIRED_ACCESS
+    queue(registerCommand, 2, value);
+#else
+    queue(registerCommand, 1, value & 0xFF);
+    queue(registerCommand + (1 << 1), 1, value >> 8);
+#endif
+}
+
+void XRA1405_Batch::queue(uint8_t registerCommand, uint8_t length, uint16_t value)
+{
+    if (_count == XRA1405_BATCH_CAPACITY)
+    {
+        commit(); // Full, send what we have and keep queueing
+    }
+
+    Frame &frame = _frames[_count++];
+    frame.commandByte = setWriteMode(registerCommand);
+    frame.length = length;
+    frame.data[0] = value & 0xFF;
+    frame.data[1] = value >> 8;
+}
+
+uint8_t XRA1405_Batch::commit()
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    XRA1405::Lock lock(*_device);
+
+    // One transaction for the whole batch, CS is still toggled per frame so the chip latches each write
+    _device->transport().beginTransaction(_device->_clock);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Frame &frame = _frames[i];
+        uint8_t buffer[3] = {frame.commandByte, frame.data[0], frame.data[1]};
+        _device->transferFrame(buffer, frame.length + 1);
+    }
+    _device->transport().endTransaction();
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Frame &frame = _frames[i];
+        _device->updateShadow(frame.commandByte, frame.data[0]);
+        if (frame.length == 2)
+        {
+            _device->updateShadow(frame.commandByte + (1 << 1), frame.data[1]);
+        }
+    }
+
+    uint8_t sent = _count;
+    _count = 0;
+    return sent;
+}
+
+// Default-bus devices behind the XRA1405_* functions, one per chip select pin
+static XRA1405 defaultDevices[XRA1405_MAX_DEVICES];
+static XRA1405 overflowDevice; // Uncached stand-in once every default device is taken
+static uint32_t defaultClock = XRA1405_SPI_CLOCK; // Clock passed to XRA1405_begin
+
+// Chip select pin each default device is reserved for, and whether its begin() has finished. Kept apart
+// from the devices so a lookup never reads a device while the reserving task is still assigning it.
+static uint8_t defaultPins[XRA1405_MAX_DEVICES];
+static volatile bool defaultReserved[XRA1405_MAX_DEVICES];
+static volatile bool defaultReady[XRA1405_MAX_DEVICES];
+
+#if XRA1405_THREAD_SAFE
+static portMUX_TYPE defaultDevicesLock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// Find the slot reserved for a chip select pin, or reserve a free one (call with defaultDevicesLock held)
+static int8_t reserveDevice(uint8_t chipSelectPin, bool &reserved)
+{
+    int8_t freeSlot = -1;
+    reserved = false;
+    for (uint8_t i = 0; i < XRA1405_MAX_DEVICES; i++)
+    {
+        if (!defaultReserved[i])
+        {
+            if (freeSlot < 0)
+            {
+                freeSlot = (int8_t)i;
+            }
+        }
+        else if (defaultPins[i] == chipSelectPin)
+        {
+            return (int8_t)i;
+        }
+    }
+    if (freeSlot >= 0)
+    {
+        defaultPins[freeSlot] = chipSelectPin;
+        defaultReserved[freeSlot] = true;
+        reserved = true;
+    }
+    return freeSlot;
+}
+
+XRA1405 &XRA1405_device(uint8_t chipSelectPin)
+{
+    bool reserved;
+#if XRA1405_THREAD_SAFE
+    portENTER_CRITICAL(&defaultDevicesLock);
+#endif
+    int8_t slot = reserveDevice(chipSelectPin, reserved);
+#if XRA1405_THREAD_SAFE
+    portEXIT_CRITICAL(&defaultDevicesLock);
+#endif
+
+    if (slot < 0)
+    {
+        // Every default device is taken; the stand-in is rebound per chip and is not thread safe
+        if (overflowDevice.chipSelectPin() != chipSelectPin)
+        {
+            overflowDevice = XRA1405(chipSelectPin, SPI, defaultClock);
+            overflowDevice.begin();
+        }
+        return overflowDevice;
+    }
+
+    XRA1405 &device = defaultDevices[slot];
+    if (reserved)
+    {
+        // Only the reserving task touches the device until it is marked ready
+        device = XRA1405(chipSelectPin, SPI, defaultClock);
+        device.begin();
+        defaultReady[slot] = true;
+    }
+    else
+    {
+        // Another task reserved this chip first: wait for its begin() to finish
+        while (!defaultReady[slot])
+        {
+#if XRA1405_THREAD_SAFE
+            vTaskDelay(1);
+#endif
+        }
+    }
+    return device;
+}
+
+void XRA1405_begin(int8_t sck, int8_t miso, int8_t mosi, uint32_t freq)
+{
+    // Keep the frequency within the supported range, every default device runs its transactions at it
+    defaultClock = XRA1405::validClock(freq);
+
+    SPI.begin(sck, miso, mosi, -1); // Initialize the SPI bus with specified pins
+
+    for (uint8_t i = 0; i < XRA1405_MAX_DEVICES; i++)
+    {
+        defaultDevices[i].setClock(defaultClock);
+    }
+    overflowDevice.setClock(defaultClock);
+}
+
+void XRA1405_pinMode(uint8_t chipSelectPin, uint8_t pin, uint8_t mode)
+{
+    XRA1405_device(chipSelectPin).pinMode(pin, mode);
+}
+
+void XRA1405_digitalWrite(uint8_t chipSelectPin, uint8_t pin, uint8_t value)
+{
+    XRA1405_device(chipSelectPin).digitalWrite(pin, value);
+}
+
+uint8_t XRA1405_digitalRead(uint8_t chipSelectPin, uint8_t pin)
+{
+    return XRA1405_device(chipSelectPin).digitalRead(pin);
+}
+
+uint16_t XRA1405_readPort(uint8_t chipSelectPin)
+{
+    return XRA1405_device(chipSelectPin).readPort();
+}
+
+void XRA1405_writePort(uint8_t chipSelectPin, uint16_t value)
+{
+    XRA1405_device(chipSelectPin).writePort(value);
+}
+
+void XRA1405_writePortMasked(uint8_t chipSelectPin, uint16_t mask, uint16_t value)
+{
+    XRA1405_device(chipSelectPin).writePortMasked(mask, value);
+}
+
+void XRA1405_setMask(uint8_t chipSelectPin, uint16_t mask)
+{
+    XRA1405_device(chipSelectPin).setMask(mask);
+}
+
+void XRA1405_clearMask(uint8_t chipSelectPin, uint16_t mask)
+{
+    XRA1405_device(chipSelectPin).clearMask(mask);
+}
+
+void XRA1405_toggleMask(uint8_t chipSelectPin, uint16_t mask)
+{
+    XRA1405_device(chipSelectPin).toggleMask(mask);
+}
+
+void XRA1405_setPullUp(uint8_t chipSelectPin, uint8_t pin, bool enabled)
+{
+    XRA1405_device(chipSelectPin).setPullUp(pin, enabled);
+}
+
+void XRA1405_setInterrupt(uint8_t chipSelectPin, uint8_t pin, XRA1405_InterruptType interruptType)
+{
+    XRA1405_device(chipSelectPin).setInterrupt(pin, interruptType);
+}
+
+void XRA1405_setInputPolarity(uint8_t chipSelectPin, uint8_t pin, bool inverted)
+{
+    XRA1405_device(chipSelectPin).setInputPolarity(pin, inverted);
+}
+
+void XRA1405_setInputPolarityPort(uint8_t chipSelectPin, uint16_t invertedMask)
+{
+    XRA1405_device(chipSelectPin).setInputPolarityPort(invertedMask);
+}
+
+void XRA1405_setThreeState(uint8_t chipSelectPin, uint8_t pin, bool enabled)
+{
+    XRA1405_device(chipSelectPin).setThreeState(pin, enabled);
+}
+
+void XRA1405_setThreeStatePort(uint8_t chipSelectPin, uint16_t threeStateMask)
+{
+    XRA1405_device(chipSelectPin).setThreeStatePort(threeStateMask);
+}
+
+void XRA1405_setInputFilter(uint8_t chipSelectPin, uint8_t pin, bool enabled)
+{
+    XRA1405_device(chipSelectPin).setInputFilter(pin, enabled);
+}
+
+void XRA1405_setInputFilterPort(uint8_t chipSelectPin, uint16_t filterMask)
+{
+    XRA1405_device(chipSelectPin).setInputFilterPort(filterMask);
+}
+
+uint8_t XRA1405_readRegister(uint8_t chipSelectPin, XRA1405_Register registerCommand)
+{
+    return XRA1405_device(chipSelectPin).readRegister(registerCommand);
+}
+
+void XRA1405_writeRegister(uint8_t chipSelectPin, XRA1405_Register registerCommand, uint8_t value)
+{
+    XRA1405_device(chipSelectPin).writeRegister(registerCommand, value);
+}
+
+uint16_t XRA1405_readRegister16(uint8_t chipSelectPin, XRA1405_Register registerCommand)
+{
+    return XRA1405_device(chipSelectPin).readRegister16(registerCommand);
+}
+
+void XRA1405_writeRegister16(uint8_t chipSelectPin, XRA1405_Register registerCommand, uint16_t value)
+{
+    XRA1405_device(chipSelectPin).writeRegister16(registerCommand, value);
+}
+
+uint16_t XRA1405_clearInterrupts(uint8_t chipSelectPin)
+{
+    return XRA1405_device(chipSelectPin).clearInterrupts();
+}
+
+uint16_t XRA1405_readAndClearInterrupts(uint8_t chipSelectPin, uint16_t *state)
+{
+    return XRA1405_device(chipSelectPin).readAndClearInterrupts(state);
+}
+
+void XRA1405_configure(uint8_t chipSelectPin, const XRA1405_Config &config)
+{
+    XRA1405_device(chipSelectPin).configure(config);
+}
+
+bool XRA1405_selfTest(uint8_t chipSelectPin, XRA1405_SelfTestResult &result, bool allRegisters)
+{
+    return XRA1405_device(chipSelectPin).selfTest(result, allRegisters);
+}
+
+bool XRA1405_qualifyClock(uint8_t chipSelectPin, XRA1405_SelfTestResult &result, bool allRegisters)
+{
+    return XRA1405_device(chipSelectPin).qualifyClock(result, allRegisters);
+}
+
+#if XRA1405_ENABLE_STATS
+const XRA1405_Stats &XRA1405_stats(uint8_t chipSelectPin)
+{
+    return XRA1405_device(chipSelectPin).stats();
+}
+
+void XRA1405_resetStats(uint8_t chipSelectPin)
+{
+    XRA1405_device(chipSelectPin).resetStats();
+}
+#endif
+
+void XRA1405_attachInterrupt(uint8_t chipSelectPin, uint8_t irqPin, XRA1405_ChangeCallback callback, void *context)
+{
+    XRA1405_device(chipSelectPin).attachInterrupt(irqPin, callback, context);
+}
+
+uint16_t XRA1405_serviceInterrupts(uint8_t chipSelectPin)
+{
+    return XRA1405_device(chipSelectPin).serviceInterrupts();
+}
+
+void XRA1405_setInputGating(uint8_t chipSelectPin, bool enabled)
+{
+    XRA1405_device(chipSelectPin).setInputGating(enabled);
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool XRA1405_prepareSleep(uint8_t chipSelectPin, uint16_t wakePins, XRA1405_InterruptType edges)
+{
+    return XRA1405_device(chipSelectPin).prepareSleep(wakePins, edges);
+}
+
+uint16_t XRA1405_resume(uint8_t chipSelectPin, uint16_t *state)
+{
+    return XRA1405_device(chipSelectPin).resume(state);
+}
+#endif
+
+bool XRA1405_enableCache(uint8_t chipSelectPin)
+{
+    XRA1405 &device = XRA1405_device(chipSelectPin);
+    if (&device == &overflowDevice)
+    {
+        return false; // The stand-in is rebound on every new chip, its shadow would not stay valid
+    }
+
+    device.enableCache();
+    return true;
+}
+
+void XRA1405_disableCache(uint8_t chipSelectPin)
+{
+    XRA1405_device(chipSelectPin).disableCache();
+}
+
+bool XRA1405_resyncCache(uint8_t chipSelectPin)
+{
+    return XRA1405_device(chipSelectPin).resyncCache();
+}
+
+void XRA1405_dumpRegisters(uint8_t chipSelectPin, XRA1405_RegisterMap &map, bool readState)
+{
+    XRA1405_device(chipSelectPin).dumpRegisters(map, readState);
+}
+
+void XRA1405_restoreRegisters(uint8_t chipSelectPin, const XRA1405_RegisterMap &map)
+{
+    XRA1405_device(chipSelectPin).restoreRegisters(map);
+}
+
+uint8_t XRA1405_repairRegisters(uint8_t chipSelectPin, uint16_t pairs)
+{
+    return XRA1405_device(chipSelectPin).repairRegisters(pairs);
+}
+
+static uint8_t setReadMode(uint8_t commandByte)
+{
+    // Set the MSB to 1 to indicate a read operation
+    return commandByte | XRA1405_READ;
+}
+
+static uint8_t setWriteMode(uint8_t commandByte)
+{
+    // Ensure the MSB is 0 to indicate a write operation
+    return commandByte & XRA1405_WRITE;
+}
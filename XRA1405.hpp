@@ -14,18 +14,95 @@
  *    - Enabling or disabling internal pull-up resistors
  *    - Configuring interrupts for GPIO pins
  *    - Clearing triggered interrupts
+ *    - Optional per-chip shadow register cache that removes the read from read-modify-write setters
+ *    - Reading and writing all 16 pins as one port value
+ *    - One XRA1405 object per chip with its own SPI bus, settings and cached state
+ *    - Batching many register writes into one bus transaction
+ *    - Optional locking for FreeRTOS tasks sharing a bus (XRA1405_THREAD_SAFE)
+ *    - Describing a whole chip's configuration at compile time and sending it in one burst
+ *    - Change notification driven by the chip's IRQ# output
+ *    - Input polarity inversion, output three-state and input filter control per pin or per port
+ *    - Raw register access for anything the API does not cover
+ *    - Register readback self-test and SPI clock qualification
+ *    - Optional bus statistics per device (XRA1405_ENABLE_STATS)
+ *    - Full register map snapshot and restore in one transaction each
+ *    - Interrupt-gated input reads served from the last GSR value while IRQ# is idle
+ *    - Pluggable bus transport: Arduino SPI, ESP-IDF spi_master or an in-memory mock chip
+ *    - Periodic register check against the shadow cache that rewrites only what a chip reset changed
+ *    - Light sleep with the expander's IRQ# as wake source (ESP32)
  *
  *    SPI Command Byte Format:
  *    - Bit 7 for Read/Write (1 for Read, 0 for Write)
  *    - Bits 6:1 for the Command Byte (the register address)
  *    - Bit 0 is reserved
  *
+ *    Paired Register Access:
+ *    Every register comes as a P0-P7 / P8-P15 pair at consecutive addresses. Port-wide calls keep CS low
+ *    after the first data byte and clock a second one, which the chip serves from the other register of
+ *    the pair. Define XRA1405_PAIRED_ACCESS as 0 to fall back to one frame per register.
+ *
+ *    Build Options:
+ *    The XRA1405_* settings guarded by #ifndef below (clock range, XRA1405_THREAD_SAFE,
+ *    XRA1405_ENABLE_STATS, XRA1405_MAX_DEVICES, ...) are compiler flags: pass them with -D, e.g.
+ *    `build_flags = -DXRA1405_ENABLE_STATS=1` in PlatformIO. The Arduino IDE compiles the library apart
+ *    from the sketch, so a #define in the sketch never reaches it and the two would disagree on the class
+ *    layout. The clock range can also be narrowed per device at runtime with XRA1405::setClockLimits().
+ *
  * Usage and Examples:
+ *    Use a device object per chip, e.g. for expanders on a second bus:
+ *      `SPIClass hspi(HSPI);`
+ *      `XRA1405 expander(15, hspi);`
+ *      `expander.begin(true); // Configure CS and enable the shadow register cache`
+ *      `expander.digitalWrite(3, HIGH);`
+ *
+ *    The XRA1405_* functions below use one such device per chip select pin on the default `SPI` bus.
+ *
+ *    Run the same driver against a simulated chip on the host (XRA1405Mock.hpp):
+ *      `XRA1405_MockTransport mock;`
+ *      `XRA1405 expander(mock);`
+ *      `expander.writePort(0x00FF); // mock.frames(), mock.busNanos() tell what it cost`
+ *
+ *    Queue register writes and send them in one bus transaction:
+ *      `XRA1405_Batch tx = expander.beginBatch();`
+ *      `tx.write16(GCR1, 0xFF00); // P0-P7 outputs, P8-P15 inputs`
+ *      `tx.write16(PUR1, 0xFF00); // Pull-ups on the inputs`
+ *      `tx.commit();`
+ *
+ *    Describe every pin once; the register values are folded at compile time (unlisted pins stay inputs):
+ *      `constexpr XRA1405_Config boardConfig = XRA1405_makeConfig(`
+ *      `    XRA1405_output(LOW),                          // P0`
+ *      `    XRA1405_output(HIGH),                         // P1`
+ *      `    XRA1405_input(true, INTERRUPT_FALLING));      // P2 with pull-up and falling edge interrupt`
+ *      `expander.configure(boardConfig); // One frame per register pair`
+ *
+ *    Get notified of input changes instead of polling (IRQ# wired to host pin 4):
+ *      `void onChange(XRA1405 &chip, uint16_t changed, uint16_t state, void *context) { ... }`
+ *      `expander.attachInterrupt(4, onChange);`
+ *      `expander.serviceInterrupts(); // From loop() or a task, delivers onChange when the IRQ fired`
+ *
+ *    Sleep until an input changes (ESP32, needs attachInterrupt; the cache skips redundant writes):
+ *      `if (expander.prepareSleep(0xFF00)) { esp_light_sleep_start(); }`
+ *      `uint16_t woke = expander.resume(); // Pins that fired, read before anything else on wake`
+ *
+ *    Skip the bus for input reads while IRQ# shows nothing changed (needs attachInterrupt and the cache):
+ *      `expander.setInputGating(true);`
+ *      `uint8_t level = expander.digitalRead(9); // No SPI traffic unless IRQ# asserted since the last read`
+ *
  *    Initialize the SPI bus:
- *      `XRA1405_begin(26000000, SCK, MISO, MOSI, SS); // Initialize SPI with 26MHz clock`
+ *      `XRA1405_begin(SCK, MISO, MOSI, 10000000); // Initialize SPI, chips on it are clocked at 10MHz`
  *
  *    Set the mode of a GPIO pin:
  *      `XRA1405_pinMode(SS, 3, OUTPUT); // Set pin 3 as an output`
+ *      `XRA1405_pinMode(SS, 4, XRA1405_THREE_STATE); // Output with the driver released`
+ *
+ *    Let the chip invert inputs, release outputs or bypass the input filter:
+ *      `XRA1405_setInputPolarityPort(SS, 0xFF00); // GSR reads P8-P15 inverted (active-low buttons)`
+ *      `XRA1405_setThreeState(SS, 4, false); // Drive pin 4 again`
+ *      `XRA1405_setInputFilter(SS, 2, false); // Interrupt on any edge of pin 2, however short`
+ *
+ *    Reach any register directly (the 16-bit forms take the P0-P7 register of a pair):
+ *      `uint16_t filters = XRA1405_readRegister16(SS, IFR1);`
+ *      `XRA1405_writeRegister(SS, TSCR2, 0x0F);`
  *
  *    Write to a GPIO pin:
  *      `XRA1405_digitalWrite(SS, 3, HIGH); // Set pin 3 high`
@@ -42,6 +119,36 @@
  *    Clear any triggered interrupts:
  *      `XRA1405_clearInterrupts(SS); // Clear all triggered interrupts`
  *
+ *    See which pins fired and clear them in one transaction:
+ *      `uint16_t state;`
+ *      `uint16_t fired = XRA1405_readAndClearInterrupts(SS, &state); // state gets the GSR snapshot`
+ *
+ *    Cache the writable registers so setters only issue the write:
+ *      `XRA1405_enableCache(SS); // Populate the shadow registers once from the chip`
+ *      `XRA1405_resyncCache(SS); // Re-read them if the chip may have been reset`
+ *
+ *    Snapshot every register and put the writable ones back later (one transaction each):
+ *      `XRA1405_RegisterMap snapshot;`
+ *      `expander.dumpRegisters(snapshot, false); // false: leave GSR/ISR and any pending interrupt alone`
+ *      `expander.restoreRegisters(snapshot);`
+ *
+ *    Catch a chip that reset behind the driver's back (needs the cache), e.g. once a second:
+ *      `if (expander.repairRegisters() != 0) { ... } // Only the differing registers were rewritten`
+ *
+ *    Fixed pins resolve their register and bit mask at compile time:
+ *      `expander.write<3>(HIGH);`
+ *      `uint8_t button = expander.read<12>();`
+ *      `XRA1405_digitalWrite<3>(SS, LOW);`
+ *
+ *    Read or write all 16 pins in one frame:
+ *      `uint16_t inputs = XRA1405_readPort(SS); // Bit n holds the state of pin n`
+ *      `XRA1405_writePortMasked(SS, 0x00F0, 0x0050); // Drive pins 4 and 6 high, pins 5 and 7 low`
+ *
+ *    Change several outputs at the same instant (one OCR write, only OCR1 for P0-P7 masks):
+ *      `XRA1405_setMask(SS, 0x0003);    // Pins 0 and 1 high`
+ *      `XRA1405_clearMask(SS, 0x0300);  // Pins 8 and 9 low`
+ *      `XRA1405_toggleMask(SS, 0x00FF); // Invert P0-P7`
+ *
  * @author
  *    Itay Nave, Embedded Software Engineer
  * @date
@@ -61,13 +168,97 @@
 #include <Arduino.h>
 #include <SPI.h>
 
+#if defined(ARDUINO_ARCH_ESP32)
+#include <soc/gpio_reg.h>
+#endif
+
 #define XRA1405_SPI_CLOCK 26000000 // 26 MHz
+
+// Valid SPI clock range. 26 MHz is the datasheet limit at VCC 2.5V/3.3V (15 MHz at 1.8V).
+// Override XRA1405_SPI_CLOCK_MAX with -D to raise the ceiling for short traces; to cap the clock for
+// long cable runs or a 1.8V supply, use XRA1405::setClockLimits() instead (see Build Options above).
+#ifndef XRA1405_SPI_CLOCK_MIN
+#define XRA1405_SPI_CLOCK_MIN 100000 // 100 kHz
+#endif
+#ifndef XRA1405_SPI_CLOCK_MAX
+#define XRA1405_SPI_CLOCK_MAX 26000000 // 26 MHz
+#endif
 #define SPI_ORDER MSBFIRST
 #define SPI_MODE SPI_MODE0
 
 #define XRA1405_WRITE B01111111
 #define XRA1405_READ B10000000
 
+#define XRA1405_REGISTER_COUNT 22 // Number of registers in the XRA1405 register map (GSR1..IFR2)
+
+// Port-wide calls move both registers of a pair in one CS frame (set to 0 for one frame per register)
+#ifndef XRA1405_PAIRED_ACCESS
+#define XRA1405_PAIRED_ACCESS 1
+#endif
+
+#define XRA1405_NO_PIN 0xFF // Chip select placeholder for a device that is not bound to a chip yet
+
+#define XRA1405_THREE_STATE 0x80 // pinMode() mode: output with its driver disabled (TSCR set)
+
+// Register pair selectors for repairRegisters(), one bit per pair, named by its P0-P7 register
+#define XRA1405_CHECK_PAIR(registerCommand) (1U << ((registerCommand) >> 2))
+#define XRA1405_CHECK_DEFAULT (XRA1405_CHECK_PAIR(OCR1) | XRA1405_CHECK_PAIR(GCR1) | XRA1405_CHECK_PAIR(IER1))
+#define XRA1405_CHECK_ALL 0x077E // Every writable pair (all but GSR and ISR)
+
+// On ESP32, drive CS through cached GPIO set/clear registers instead of digitalWrite (set to 0 to disable)
+#ifndef XRA1405_FAST_CS
+#define XRA1405_FAST_CS 1
+#endif
+
+// Serialize bus access and read-modify-write sequences between FreeRTOS tasks (ESP32, -D to 1 to enable).
+// Devices on the same bus (same XRA1405_Transport::busKey()) share one recursive mutex; setLocking(false)
+// skips it for a chip that is only ever touched from one task.
+#ifndef XRA1405_THREAD_SAFE
+#define XRA1405_THREAD_SAFE 0
+#endif
+
+#if XRA1405_THREAD_SAFE && !defined(ARDUINO_ARCH_ESP32)
+#error "XRA1405_THREAD_SAFE needs FreeRTOS (ESP32)"
+#endif
+
+// Number of distinct SPI buses that get their own mutex when XRA1405_THREAD_SAFE is enabled
+#ifndef XRA1405_MAX_BUSES
+#define XRA1405_MAX_BUSES 4
+#endif
+
+// Number of frames an XRA1405_Batch holds before it flushes on its own
+#ifndef XRA1405_BATCH_CAPACITY
+#define XRA1405_BATCH_CAPACITY 24
+#endif
+
+// Number of chips the XRA1405_* functions can address (each one gets its own default-bus device, -D only)
+#ifndef XRA1405_MAX_DEVICES
+#define XRA1405_MAX_DEVICES 16
+#endif
+
+// Cores whose attachInterruptArg() hands the ISR a context pointer. Everywhere else (AVR, SAMD, ...)
+// IRQ# goes through one of XRA1405_MAX_IRQ_DEVICES plain-function trampolines.
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+#define XRA1405_INTERRUPT_ARG 1
+#else
+#define XRA1405_INTERRUPT_ARG 0
+#endif
+
+// Number of devices that can have attachInterrupt() active at once on cores without attachInterruptArg()
+#ifndef XRA1405_MAX_IRQ_DEVICES
+#define XRA1405_MAX_IRQ_DEVICES 4
+#endif
+
+// Count frames, bytes, cache hits and frame latency per device (-D to 1 to enable, costs ~300 bytes RAM per device)
+#ifndef XRA1405_ENABLE_STATS
+#define XRA1405_ENABLE_STATS 0
+#endif
+
+// Latency histogram buckets; bucket n counts frames that took [2^n, 2^(n+1)) ticks, the last one is open-ended
+#ifndef XRA1405_STATS_BUCKETS
+#define XRA1405_STATS_BUCKETS 16
+#endif
+
 // Enum for XRA1405 register addresses with pre-shifted values for direct use in SPI command byte
 enum XRA1405_Register
 {
@@ -104,15 +295,589 @@ enum XRA1405_InterruptType
     INTERRUPT_BOTH         // Enable both rising and falling edge interrupts
 };
 
-// Setting the read or write mode in the command byte
-static uint8_t SPI_Read(uint8_t chipSelectPin, uint8_t commandByte);
-static void SPI_Write(uint8_t chipSelectPin, uint8_t commandByte, uint8_t dataByte);
-static uint8_t setReadMode(uint8_t commandByte);
-static uint8_t setWriteMode(uint8_t commandByte);
-static void configureEdgeInterrupt(uint8_t chipSelectPin, uint8_t pin, XRA1405_InterruptType interruptType);
+// Settings of one pin, built with XRA1405_output() or XRA1405_input()
+struct XRA1405_PinConfig
+{
+    bool output;                       // Output (GCR = 0) or input (GCR = 1)
+    bool initialValue;                 // Output level written to OCR
+    bool threeState;                   // Output three-state (TSCR)
+    bool pullUp;                       // Input pull-up resistor (PUR)
+    bool invert;                       // Input polarity inversion (PIR)
+    bool filter;                       // Input filter (IFR), enabled on the chip by default
+    XRA1405_InterruptType interrupt;   // Input edge interrupt (IER, REIR, FEIR)
+};
+
+// Values of every writable register pair of one chip, the low byte holds P0-P7
+struct XRA1405_Config
+{
+    uint16_t ocr;
+    uint16_t pir;
+    uint16_t gcr;
+    uint16_t pur;
+    uint16_t ier;
+    uint16_t tscr;
+    uint16_t reir;
+    uint16_t feir;
+    uint16_t ifr;
+};
+
+// Byte-for-byte image of the register file, in XRA1405_Register address order
+struct XRA1405_RegisterMap
+{
+    uint8_t gsr1, gsr2;
+    uint8_t ocr1, ocr2;
+    uint8_t pir1, pir2;
+    uint8_t gcr1, gcr2;
+    uint8_t pur1, pur2;
+    uint8_t ier1, ier2;
+    uint8_t tscr1, tscr2;
+    uint8_t isr1, isr2;
+    uint8_t reir1, reir2;
+    uint8_t feir1, feir2;
+    uint8_t ifr1, ifr2;
+};
+
+static_assert(sizeof(XRA1405_RegisterMap) == XRA1405_REGISTER_COUNT, "XRA1405_RegisterMap must mirror the register file");
+
+// Outcome of XRA1405::selfTest() / qualifyClock()
+struct XRA1405_SelfTestResult
+{
+    bool passed;              // Every pattern read back intact
+    uint8_t failedRegister;   // First register pair that mismatched (P0-P7 register), GSR1 if none
+    uint16_t expected;        // Value written to failedRegister
+    uint16_t actual;          // Value read back from failedRegister
+    uint16_t errorBits;       // OR of all mismatched bits, a constant pattern points at a stuck data line
+    uint32_t maxClock;        // Fastest clock that passed (qualifyClock only, 0 if none did)
+};
+
+#if XRA1405_ENABLE_STATS
+// Bus usage of one device since construction or the last resetStats().
+// Latency ticks are CPU cycles on ESP32 and microseconds elsewhere, measured around each CS frame.
+struct XRA1405_Stats
+{
+    uint32_t reads[XRA1405_REGISTER_COUNT];   // Register reads that went to the chip, by address (command byte >> 1)
+    uint32_t writes[XRA1405_REGISTER_COUNT];  // Register writes sent to the chip, by address
+    uint32_t frames;                          // CS frames
+    uint32_t bytes;                           // Bytes clocked, command bytes included
+    uint32_t cacheHits;                       // Register reads served from the shadow cache
+    uint32_t cacheMisses;                     // Register reads that had to use the bus (cache off, GSR or ISR)
+    uint32_t latency[XRA1405_STATS_BUCKETS]; // Frame duration histogram
+};
+#endif
+
+// Pin driven by the chip, optionally three-stated
+constexpr XRA1405_PinConfig XRA1405_output(uint8_t initialValue = LOW, bool threeState = false)
+{
+    return XRA1405_PinConfig{true, initialValue == HIGH, threeState, false, false, true, INTERRUPT_DISABLE};
+}
+
+// Pin read by the chip
+constexpr XRA1405_PinConfig XRA1405_input(bool pullUp = false, XRA1405_InterruptType interrupt = INTERRUPT_DISABLE,
+                                          bool invert = false, bool filter = true)
+{
+    // OCR stays at its reset value (1) so the pin comes up high if it is switched to an output later
+    return XRA1405_PinConfig{false, true, false, pullUp, invert, filter, interrupt};
+}
+
+namespace XRA1405_detail
+{
+    constexpr uint16_t bit(bool set, uint8_t pin)
+    {
+        return set ? (uint16_t)(1u << pin) : 0;
+    }
+
+    constexpr XRA1405_Config pinBits(const XRA1405_PinConfig &config, uint8_t pin)
+    {
+        return XRA1405_Config{
+            bit(config.initialValue, pin),
+            bit(!config.output && config.invert, pin),
+            bit(!config.output, pin),
+            bit(!config.output && config.pullUp, pin),
+            bit(!config.output && config.interrupt != INTERRUPT_DISABLE, pin),
+            bit(config.output && config.threeState, pin),
+            bit(!config.output && (config.interrupt == INTERRUPT_RISING || config.interrupt == INTERRUPT_BOTH), pin),
+            bit(!config.output && (config.interrupt == INTERRUPT_FALLING || config.interrupt == INTERRUPT_BOTH), pin),
+            bit(config.filter, pin)};
+    }
+
+    constexpr XRA1405_Config merge(const XRA1405_Config &a, const XRA1405_Config &b)
+    {
+        return XRA1405_Config{
+            (uint16_t)(a.ocr | b.ocr), (uint16_t)(a.pir | b.pir), (uint16_t)(a.gcr | b.gcr),
+            (uint16_t)(a.pur | b.pur), (uint16_t)(a.ier | b.ier), (uint16_t)(a.tscr | b.tscr),
+            (uint16_t)(a.reir | b.reir), (uint16_t)(a.feir | b.feir), (uint16_t)(a.ifr | b.ifr)};
+    }
+
+    // Pins past the last listed one keep the chip's reset configuration
+    constexpr XRA1405_Config fold(uint8_t pin)
+    {
+        return pin >= 16 ? XRA1405_Config{0, 0, 0, 0, 0, 0, 0, 0, 0} : merge(pinBits(XRA1405_input(), pin), fold(pin + 1));
+    }
+
+    template <typename... Rest>
+    constexpr XRA1405_Config fold(uint8_t pin, const XRA1405_PinConfig &first, const Rest &...rest)
+    {
+        return merge(pinBits(first, pin), fold(pin + 1, rest...));
+    }
+}
+
+// Fold up to 16 pin settings (P0 first) into the register values of a chip
+template <typename... Pins>
+constexpr XRA1405_Config XRA1405_makeConfig(const Pins &...pins)
+{
+    static_assert(sizeof...(Pins) <= 16, "The XRA1405 has 16 pins");
+    return XRA1405_detail::fold(0, pins...);
+}
+
+// Register commands and bit mask of a pin known at compile time
+template <uint8_t Pin>
+struct XRA1405_Pin
+{
+    static_assert(Pin < 16, "The XRA1405 has 16 pins");
+
+    static constexpr uint8_t outputRegister = Pin < 8 ? OCR1 : OCR2;
+    static constexpr uint8_t stateRegister = Pin < 8 ? GSR1 : GSR2;
+    static constexpr uint8_t mask = 1 << (Pin % 8);
+};
+
+// Moves CS frames between the driver and one chip. XRA1405 reaches the bus only through this, so the
+// same driver runs on Arduino SPI (the default), on the ESP-IDF spi_master driver (XRA1405_IdfTransport
+// in XRA1405Esp32Dma.hpp) or against the simulated register file of XRA1405_MockTransport (XRA1405Mock.hpp).
+class XRA1405_Transport
+{
+public:
+    virtual ~XRA1405_Transport() {}
+
+    // Get the chip select line ready and leave the chip deselected
+    virtual void begin() = 0;
+
+    // Claim the bus at the given clock for one or more frames, release it again
+    virtual void beginTransaction(uint32_t clock) = 0;
+    virtual void endTransaction() = 0;
+
+    // One CS frame, command byte then data bytes; data is replaced by what the chip returned
+    virtual void transfer(uint8_t *data, uint8_t length) = 0;
+
+    // Devices whose transports return the same key share one mutex under XRA1405_THREAD_SAFE and may
+    // form an XRA1405_Group
+    virtual const void *busKey() const { return this; }
+};
+
+// Arduino SPIClass bus with CS on a GPIO. Every XRA1405 built from a chip select pin owns one.
+class XRA1405_ArduinoTransport : public XRA1405_Transport
+{
+public:
+    explicit XRA1405_ArduinoTransport(uint8_t chipSelectPin = XRA1405_NO_PIN, SPIClass &spi = SPI);
+
+    void begin();
+    void beginTransaction(uint32_t clock);
+    void endTransaction();
+    void transfer(uint8_t *data, uint8_t length);
+    const void *busKey() const { return _spi; }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Let the SPI peripheral drive CS instead of the GPIO
+    void setHardwareChipSelect(bool enabled);
+#endif
+
+    SPIClass &spi() const { return *_spi; }
+
+private:
+    void selectChip();
+    void deselectChip();
+
+    SPIClass *_spi;
+    SPISettings _settings; // Rebuilt only when the clock changes
+    uint32_t _clock;
+    uint8_t _chipSelectPin;
+#if defined(ARDUINO_ARCH_ESP32)
+    bool _hardwareChipSelect;
+#endif
+#if XRA1405_FAST_CS && defined(ARDUINO_ARCH_ESP32)
+    volatile uint32_t *_chipSelectSetRegister;
+    volatile uint32_t *_chipSelectClearRegister;
+    uint32_t _chipSelectMask;
+#endif
+};
+
+class XRA1405_Batch;
+class XRA1405;
+
+// Input change notification: changedMask holds the pins reported by ISR1/ISR2, state the GSR1/GSR2 value
+typedef void (*XRA1405_ChangeCallback)(XRA1405 &device, uint16_t changedMask, uint16_t state, void *context);
+
+class XRA1405
+{
+public:
+    // Create a device on the given SPI bus. The bus itself is started by XRA1405_begin or SPIClass::begin.
+    XRA1405(uint8_t chipSelectPin = XRA1405_NO_PIN, SPIClass &spi = SPI, uint32_t freq = XRA1405_SPI_CLOCK);
+
+    // Create a device that talks through another transport (ESP-IDF driver, mock, ...). The transport
+    // must outlive the device; chipSelectPin() reports XRA1405_NO_PIN for it.
+    explicit XRA1405(XRA1405_Transport &transport, uint32_t freq = XRA1405_SPI_CLOCK);
+
+    // Configure the chip select pin and optionally populate the shadow register cache
+    void begin(bool useCache = false);
+
+    // Set the SPI clock used for every frame to this chip (clamped to the device's clock limits)
+    void setClock(uint32_t freq);
+    uint32_t clock() const { return _clock; }
+
+    // Narrow the clock range of this chip within XRA1405_SPI_CLOCK_MIN..MAX, e.g. 15 MHz for a 1.8V
+    // supply. setClock(), selfTest() and qualifyClock() stay inside it; the current clock is clamped
+    // to it. Returns false and changes nothing if minFreq > maxFreq after clamping.
+    bool setClockLimits(uint32_t minFreq, uint32_t maxFreq);
+    uint32_t minClock() const { return _minClock; }
+    uint32_t maxClock() const { return _maxClock; }
+
+    // Clamp a requested clock to the supported range (the build-time limits, not setClockLimits())
+    static uint32_t validClock(uint32_t freq);
+
+    // Take the per-bus mutex around every operation (default when XRA1405_THREAD_SAFE is enabled).
+    // Turning it off is the lock-free fast path for a chip only one task talks to.
+    void setLocking(bool enabled) { _locking = enabled; }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Let the SPI peripheral drive CS. The bus must have been started with this chip's CS as its SS pin,
+    // e.g. `spi.begin(SCK, MISO, MOSI, 15)`, so only one chip per bus can use it.
+    void setHardwareChipSelect(bool enabled);
+#endif
+
+    // Set the mode of a GPIO pin (INPUT, INPUT_PULLUP, OUTPUT or XRA1405_THREE_STATE).
+    // OUTPUT also clears the pin's three-state bit so it actually drives.
+    void pinMode(uint8_t pin, uint8_t mode);
+
+    // Write to a GPIO pin
+    void digitalWrite(uint8_t pin, uint8_t value);
+
+    // Read from a GPIO pin
+    uint8_t digitalRead(uint8_t pin);
+
+    // Compile-time pin forms of digitalWrite/digitalRead plus a toggle, for fixed pins in hot loops.
+    // The register and bit mask are constants, leaving only the (cached) read-modify-write and the frame.
+    template <uint8_t Pin>
+    void write(uint8_t value);
+    template <uint8_t Pin>
+    uint8_t read();
+    template <uint8_t Pin>
+    void toggle();
+
+    // Read all 16 pins at once from GSR1/GSR2 (bit n = pin n)
+    uint16_t readPort();
+
+    // Write all 16 outputs at once to OCR1/OCR2 (bit n = pin n)
+    void writePort(uint16_t value);
+
+    // Write only the outputs selected by mask, leaving the others untouched
+    void writePortMasked(uint16_t mask, uint16_t value);
+
+    // Drive the outputs in mask high / low / to their opposite level, all bits in the same write
+    void setMask(uint16_t mask);
+    void clearMask(uint16_t mask);
+    void toggleMask(uint16_t mask);
+
+    // Set the outputs to (outputs & andMask) ^ xorMask in one write.
+    // Any sequence of set, clear and toggle operations folds into a single pair of masks.
+    // Only OCR1 or OCR2 is written when the masks touch a single half of the port.
+    void modifyPort(uint16_t andMask, uint16_t xorMask);
 
-// Initialize the SPI bus (only needs to be done once)
-void XRA1405_begin(int8_t sck, int8_t miso, int8_t mosi, uint32_t freq = 26000000);
+    // Enable/disable the internal pull-up resistor for a GPIO pin
+    void setPullUp(uint8_t pin, bool enabled);
+
+    // Configure the interrupt for a GPIO pin
+    void setInterrupt(uint8_t pin, XRA1405_InterruptType type);
+
+    // Invert the level GSR reports for an input (PIR)
+    void setInputPolarity(uint8_t pin, bool inverted);
+    void setInputPolarityPort(uint16_t invertedMask);
+
+    // Release (true) or drive (false) an output (TSCR)
+    void setThreeState(uint8_t pin, bool enabled);
+    void setThreeStatePort(uint16_t threeStateMask);
+
+    // Enable/disable the glitch filter on an input's interrupt path (IFR, enabled after reset)
+    void setInputFilter(uint8_t pin, bool enabled);
+    void setInputFilterPort(uint16_t filterMask);
+
+    // Raw register access. Reads always go to the chip; writes keep the shadow cache in step.
+    // The 16-bit forms take the P0-P7 register of a pair and move both in one frame.
+    uint8_t readRegister(XRA1405_Register registerCommand);
+    void writeRegister(XRA1405_Register registerCommand, uint8_t value);
+    uint16_t readRegister16(XRA1405_Register registerCommand);
+    void writeRegister16(XRA1405_Register registerCommand, uint16_t value);
+
+    // Clear any triggered interrupts. Returns the ISR1/ISR2 contents latched before clearing.
+    uint16_t clearInterrupts();
+
+    // Read ISR1/ISR2 and clear them by reading GSR1/GSR2, all in one transaction.
+    // Returns the pins that fired; state (if given) receives the GSR snapshot taken while clearing.
+    uint16_t readAndClearInterrupts(uint16_t *state = nullptr);
+
+    // Bind the chip's IRQ# output (open-drain, active low) to a host pin. The host ISR only flags the
+    // event; serviceInterrupts() reads the chip and calls the callback from task context. On cores
+    // without attachInterruptArg() more than XRA1405_MAX_IRQ_DEVICES attached devices fall back to
+    // serviceInterrupts() polling the IRQ# level.
+    void attachInterrupt(uint8_t irqPin, XRA1405_ChangeCallback callback, void *context = nullptr);
+    void detachInterrupt();
+
+    // True once the IRQ line fired and the event has not been serviced yet
+    bool interruptPending() const { return _irqPending; }
+
+    // micros() at the IRQ# edge that started the pending event, taken in the host ISR. Valid inside
+    // the change callback, where it timestamps the change rather than the moment it was serviced.
+    uint32_t interruptMicros() const { return _irqMicros; }
+
+    // If an interrupt is pending, read ISR1/ISR2 and GSR1/GSR2 in one transaction and deliver the callback.
+    // Returns the changed-pin mask (0 if nothing was pending). Never call this from an ISR.
+    uint16_t serviceInterrupts();
+
+    // Serve digitalRead/readPort/read<Pin> from the last GSR1/GSR2 value while IRQ# is idle. Only pins
+    // whose changes are guaranteed to raise IRQ# are served this way: outputs, and inputs with IER set
+    // for both edges. Other pins, and every read after IRQ# asserted, still go to the chip.
+    // Needs attachInterrupt() and the shadow cache; interrupts seen by a gated read are kept for
+    // serviceInterrupts(), so the change callback never misses them.
+    void setInputGating(bool enabled);
+    bool inputGating() const { return _inputGating; }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Have the host ISR send a FreeRTOS task notification, so a task can block in ulTaskNotifyTake
+    void setNotifyTask(TaskHandle_t task) { _notifyTask = task; }
+
+    // Get ready for light sleep with IRQ# as the only wake source. Only wakePins keep IER set, with
+    // REIR/FEIR set for the given edges; registers that already hold those values are not rewritten
+    // when the cache is enabled. Pending interrupts are acknowledged so IRQ# is released (their bits
+    // are kept for resume()), then the host IRQ pin is armed as a low-level GPIO wake source in place
+    // of its edge interrupt. Needs attachInterrupt(). Returns false, with the wake source left unarmed,
+    // if IRQ# is still asserted; call resume() in either case.
+    bool prepareSleep(uint16_t wakePins, XRA1405_InterruptType edges = INTERRUPT_BOTH);
+
+    // After waking: read ISR1/ISR2 and GSR1/GSR2 first, in one transaction, then disarm the wake source,
+    // re-attach the edge interrupt and put back the IER/REIR/FEIR setup from before prepareSleep(),
+    // writing only the pairs that differ. Returns the pins that fired; state (if given) gets GSR1/GSR2.
+    // The change callback is not called for these pins.
+    uint16_t resume(uint16_t *state = nullptr);
+#endif
+
+    // Enable the shadow register cache and populate it from the device
+    void enableCache();
+
+    // Disable the shadow register cache (setters go back to read-modify-write)
+    void disableCache();
+
+    // Re-read every register into the shadow cache. Returns false if the cache is not enabled.
+    bool resyncCache();
+
+    // Read the whole register file in one transaction, one paired frame per register pair.
+    // With readState, ISR1/ISR2 and then GSR1/GSR2 are read too; the ISR bits stay latched for the next
+    // readAndClearInterrupts()/serviceInterrupts(). Without it those four bytes are set to 0.
+    void dumpRegisters(XRA1405_RegisterMap &map, bool readState = true);
+
+    // Write every writable register of a snapshot back in one transaction (same order as configure())
+    void restoreRegisters(const XRA1405_RegisterMap &map);
+
+    // Compare the selected register pairs (XRA1405_CHECK_* bits) against the shadow cache with one paired
+    // read each, all in one transaction, and rewrite only the registers that differ in one batch, in
+    // configure() order. Returns the number of registers rewritten: 0 when the chip is healthy or the
+    // cache is off. Cheap enough to call periodically to catch a chip that browned out and reset.
+    uint8_t repairRegisters(uint16_t pairs = XRA1405_CHECK_DEFAULT);
+
+    // Start queueing register writes to be sent in one bus transaction
+    XRA1405_Batch beginBatch();
+
+    // Write a whole chip configuration in one batch (one frame per register pair)
+    void configure(const XRA1405_Config &config);
+
+    // Write test patterns to the writable register pairs in one transaction, read them all back in a
+    // second one and restore the original values. By default only PIR, REIR, FEIR and IFR are used,
+    // which cannot change what the pins do while IER is off; allRegisters adds OCR, GCR, PUR, IER and
+    // TSCR and is meant for boards with nothing connected to the expander. The originals come from the
+    // shadow cache, or are read at minClock(), and go back at that clock if the test failed.
+    bool selfTest(XRA1405_SelfTestResult &result, bool allRegisters = false);
+
+    // Run the selfTest() patterns from maxClock() downward and report the fastest passing clock
+    // in result.maxClock. The originals are saved once before the sweep and restored once at the qualified
+    // clock. The device clock is restored afterwards; call setClock(result.maxClock) to use it.
+    bool qualifyClock(XRA1405_SelfTestResult &result, bool allRegisters = false);
+
+    bool cacheEnabled() const { return _cacheEnabled; }
+    uint8_t chipSelectPin() const { return _chipSelectPin; }
+    SPIClass &bus() const { return _arduinoTransport.spi(); } // The SPIClass of the built-in transport
+
+#if XRA1405_ENABLE_STATS
+    // Counters are updated without locking; read them from the task that owns the bus for an exact snapshot
+    const XRA1405_Stats &stats() const { return _stats; }
+    void resetStats();
+#endif
+
+private:
+    // Holds the bus mutex for its scope; empty unless XRA1405_THREAD_SAFE is enabled.
+    // Recursive, so public calls can nest (e.g. serviceInterrupts -> readAndClearInterrupts).
+    class Lock
+    {
+    public:
+#if XRA1405_THREAD_SAFE
+        explicit Lock(XRA1405 &device);
+        ~Lock();
+
+    private:
+        SemaphoreHandle_t _mutex;
+#else
+        explicit Lock(XRA1405 &) {}
+#endif
+    };
+
+    // Single CS frames on the bus
+    uint8_t SPI_Read(uint8_t commandByte);
+    void SPI_Write(uint8_t commandByte, uint8_t dataByte);
+
+    // Register access that goes through the shadow cache when it is enabled
+    uint8_t readCachedRegister(uint8_t registerCommand);
+    void writeCachedRegister(uint8_t registerCommand, uint8_t value);
+    uint16_t readCachedRegister16(uint8_t registerCommand);
+
+    // readCachedRegister16() inside a transaction the caller already holds
+    uint16_t readCachedFrame16(uint8_t registerCommand);
+    void writeCachedRegister16(uint8_t registerCommand, uint16_t value);
+
+    // Set or clear one pin's bit in a register pair, lowRegister being the P0-P7 register
+    void writeCachedPinBit(uint8_t lowRegister, uint8_t pin, bool value);
+
+    void configureEdgeInterrupt(uint8_t pin, XRA1405_InterruptType interruptType);
+
+    // Self-test steps: save the tested pairs (shadow cache, else read at minClock()), run the
+    // patterns at the device clock, write values back at a given clock
+    void readSelfTestOriginals(uint16_t *values, uint8_t registerCount);
+    bool runSelfTestPatterns(XRA1405_SelfTestResult &result, uint8_t registerCount);
+    void writeSelfTestValues(const uint16_t *values, uint8_t registerCount, uint32_t clock);
+
+    // The installed transport, or the built-in Arduino one
+    XRA1405_Transport &transport() { return _transport != nullptr ? *_transport : _arduinoTransport; }
+
+    // One CS frame inside a transaction the caller already holds; data is replaced by what the chip returned
+    void transferFrame(uint8_t *data, uint8_t length);
+
+    // Register pair frames inside a transaction the caller already holds
+    uint16_t readFrame16(uint8_t registerCommand);
+
+    // ISR1/ISR2 then GSR1/GSR2 in one transaction, recording the GSR snapshot
+    uint16_t readInterruptState(uint16_t &state);
+
+    // GSR1 or GSR2 (or the pair) inside a transaction the caller already holds. Reading GSR clears the
+    // ISR register of the same half, so while interrupts are in use that ISR half is read first and
+    // latched for readAndClearInterrupts() and serviceInterrupts().
+    uint8_t readStateFrame(uint8_t registerCommand);
+    uint16_t readStateFrame16();
+
+    // IER is set or IRQ# is attached, so a GSR read may acknowledge an interrupt nobody has seen yet
+    bool interruptsInUse() const { return _interruptEnable != 0 || _irqPin != XRA1405_NO_PIN; }
+
+    // Keep ISR bits for the next readAndClearInterrupts(); with IRQ# attached, schedule serviceInterrupts()
+    void latchInterrupts(uint16_t interruptStatus);
+
+    // Input gating: fill state and return true if the snapshot can answer for all of pins
+    bool readGatedState(uint16_t pins, uint16_t &state);
+    void recordGpioState(uint16_t state, uint16_t knownMask);
+    void writeFrame16(uint8_t registerCommand, uint16_t value);
+    void writeConfigFrames(const XRA1405_Config &config);
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Write REIR, FEIR and IER in one batch, skipping pairs that already hold the value
+    void writeInterruptSetup(uint16_t enabled, uint16_t risingEdges, uint16_t fallingEdges);
+#endif
+
+    // Record a written value in the shadow cache when it is enabled
+    void updateShadow(uint8_t registerCommand, uint8_t value);
+
+#if XRA1405_ENABLE_STATS
+    void recordFrame(uint8_t commandByte, uint8_t length, uint32_t ticks);
+    XRA1405_Stats _stats;
+#endif
+
+    friend class XRA1405_Batch;
+    friend class XRA1405_Group;
+    friend class XRA1405_Matrix;
+
+    XRA1405_ArduinoTransport _arduinoTransport;
+    XRA1405_Transport *_transport; // nullptr selects _arduinoTransport; a plain pointer would not survive copies
+    uint32_t _clock;
+    uint32_t _minClock; // setClockLimits() range, XRA1405_SPI_CLOCK_MIN..MAX by default
+    uint32_t _maxClock;
+    uint8_t _chipSelectPin;
+    bool _cacheEnabled;
+    uint8_t _shadowRegisters[XRA1405_REGISTER_COUNT]; // Indexed by register address (command byte >> 1)
+
+    static void handleIrq(void *device);
+
+    // Hook handleIrq() to the falling edge of IRQ#, or unhook it
+    void attachIrqHandler();
+    void detachIrqHandler();
+
+#if !XRA1405_INTERRUPT_ARG
+    template <uint8_t Slot>
+    static void irqTrampoline();
+
+    uint8_t _irqSlot; // Trampoline in use, XRA1405_NO_PIN if none was free (serviceInterrupts() then polls IRQ#)
+#endif
+
+    uint8_t _irqPin;
+    volatile bool _irqPending;
+    volatile uint32_t _irqMicros;
+    XRA1405_ChangeCallback _changeCallback;
+    void *_changeContext;
+    bool _inputGating;
+    uint16_t _gpioState;           // Last GSR1/GSR2 value read from the chip
+    uint16_t _gpioStateKnown;      // Bits of _gpioState that are still valid
+    volatile bool _gpioStateStale; // IRQ# fired since _gpioState was taken
+    uint16_t _latchedInterrupts;   // ISR bits read before a GSR read acknowledged them, not delivered yet
+    uint16_t _interruptEnable;     // IER1/IER2 as last written or read back (0 after power-on)
+#if defined(ARDUINO_ARCH_ESP32)
+    TaskHandle_t _notifyTask;
+    uint16_t _awakeInterrupts[3]; // IER, REIR and FEIR saved by prepareSleep()
+#endif
+    bool _locking;
+#if XRA1405_THREAD_SAFE
+    SemaphoreHandle_t _busMutex; // Looked up on first use
+#endif
+};
+
+// Register writes queued for one chip and sent back to back inside a single bus transaction.
+// Frames that were not committed are dropped together with the batch.
+class XRA1405_Batch
+{
+public:
+    explicit XRA1405_Batch(XRA1405 &device);
+
+    // Queue a write to one register
+    void write(uint8_t registerCommand, uint8_t value);
+
+    // Queue a write to a register pair, the low byte goes to the P0-P7 register
+    void write16(uint8_t registerCommand, uint16_t value);
+
+    // Send every queued frame and update the shadow cache. Returns the number of frames sent.
+    uint8_t commit();
+
+    uint8_t size() const { return _count; }
+
+private:
+    struct Frame
+    {
+        uint8_t commandByte;
+        uint8_t length; // Data bytes after the command byte (1 or 2)
+        uint8_t data[2];
+    };
+
+    void queue(uint8_t registerCommand, uint8_t length, uint16_t value);
+
+    XRA1405 *_device;
+    Frame _frames[XRA1405_BATCH_CAPACITY];
+    uint8_t _count;
+};
+
+// Get the default-bus device used by the XRA1405_* functions for a chip select pin
+XRA1405 &XRA1405_device(uint8_t chipSelectPin);
+
+// Initialize the SPI bus (only needs to be done once). The clock applies to every chip on the default bus.
+void XRA1405_begin(int8_t sck, int8_t miso, int8_t mosi, uint32_t freq = XRA1405_SPI_CLOCK);
 
 // Set the mode of a GPIO pin (input, output, three-state)
 void XRA1405_pinMode(uint8_t chipSelectPin, uint8_t pin, uint8_t mode);
@@ -123,13 +888,147 @@ void XRA1405_digitalWrite(uint8_t chipSelectPin, uint8_t pin, uint8_t value);
 // Read from a GPIO pin
 uint8_t XRA1405_digitalRead(uint8_t chipSelectPin, uint8_t pin);
 
+// Read all 16 pins at once from GSR1/GSR2 (bit n = pin n)
+uint16_t XRA1405_readPort(uint8_t chipSelectPin);
+
+// Write all 16 outputs at once to OCR1/OCR2 (bit n = pin n)
+void XRA1405_writePort(uint8_t chipSelectPin, uint16_t value);
+
+// Write only the outputs selected by mask, leaving the others untouched
+void XRA1405_writePortMasked(uint8_t chipSelectPin, uint16_t mask, uint16_t value);
+
+// Drive the outputs in mask high / low / to their opposite level, all bits in the same write
+void XRA1405_setMask(uint8_t chipSelectPin, uint16_t mask);
+void XRA1405_clearMask(uint8_t chipSelectPin, uint16_t mask);
+void XRA1405_toggleMask(uint8_t chipSelectPin, uint16_t mask);
+
 // Enable/disable the internal pull-up resistor for a GPIO pin
 void XRA1405_setPullUp(uint8_t chipSelectPin, uint8_t pin, bool enabled);
 
 // Configure the interrupt for a GPIO pin
 void XRA1405_setInterrupt(uint8_t chipSelectPin, uint8_t pin, XRA1405_InterruptType type);
 
-// Clear any triggered interrupts
-void XRA1405_clearInterrupts(uint8_t chipSelectPin);
+// Invert the level GSR reports for an input (PIR)
+void XRA1405_setInputPolarity(uint8_t chipSelectPin, uint8_t pin, bool inverted);
+void XRA1405_setInputPolarityPort(uint8_t chipSelectPin, uint16_t invertedMask);
+
+// Release (true) or drive (false) an output (TSCR)
+void XRA1405_setThreeState(uint8_t chipSelectPin, uint8_t pin, bool enabled);
+void XRA1405_setThreeStatePort(uint8_t chipSelectPin, uint16_t threeStateMask);
+
+// Enable/disable the glitch filter on an input's interrupt path (IFR)
+void XRA1405_setInputFilter(uint8_t chipSelectPin, uint8_t pin, bool enabled);
+void XRA1405_setInputFilterPort(uint8_t chipSelectPin, uint16_t filterMask);
+
+// Raw register access (16-bit forms take the P0-P7 register of a pair)
+uint8_t XRA1405_readRegister(uint8_t chipSelectPin, XRA1405_Register registerCommand);
+void XRA1405_writeRegister(uint8_t chipSelectPin, XRA1405_Register registerCommand, uint8_t value);
+uint16_t XRA1405_readRegister16(uint8_t chipSelectPin, XRA1405_Register registerCommand);
+void XRA1405_writeRegister16(uint8_t chipSelectPin, XRA1405_Register registerCommand, uint16_t value);
+
+// Clear any triggered interrupts. Returns the ISR1/ISR2 contents latched before clearing.
+uint16_t XRA1405_clearInterrupts(uint8_t chipSelectPin);
+
+// Return the pins that fired and clear them in one transaction; state (if given) receives GSR1/GSR2
+uint16_t XRA1405_readAndClearInterrupts(uint8_t chipSelectPin, uint16_t *state = nullptr);
+
+// Bind a chip's IRQ# output to a host pin and get input changes through a callback
+void XRA1405_attachInterrupt(uint8_t chipSelectPin, uint8_t irqPin, XRA1405_ChangeCallback callback, void *context = nullptr);
+
+// Deliver a pending change notification for a chip (call from loop() or a task)
+uint16_t XRA1405_serviceInterrupts(uint8_t chipSelectPin);
+
+// Serve input reads from the last GSR value while the chip's IRQ# line is idle (see XRA1405::setInputGating)
+void XRA1405_setInputGating(uint8_t chipSelectPin, bool enabled);
+
+#if defined(ARDUINO_ARCH_ESP32)
+// Arm a chip's IRQ# as the light-sleep wake source for wakePins, and undo it after waking (see XRA1405::prepareSleep)
+bool XRA1405_prepareSleep(uint8_t chipSelectPin, uint16_t wakePins, XRA1405_InterruptType edges = INTERRUPT_BOTH);
+uint16_t XRA1405_resume(uint8_t chipSelectPin, uint16_t *state = nullptr);
+#endif
+
+// Write a whole chip configuration in one batch
+void XRA1405_configure(uint8_t chipSelectPin, const XRA1405_Config &config);
+
+// Register readback self-test and fastest passing clock search (see XRA1405::selfTest/qualifyClock)
+bool XRA1405_selfTest(uint8_t chipSelectPin, XRA1405_SelfTestResult &result, bool allRegisters = false);
+bool XRA1405_qualifyClock(uint8_t chipSelectPin, XRA1405_SelfTestResult &result, bool allRegisters = false);
+
+#if XRA1405_ENABLE_STATS
+// Bus statistics of a chip's default device
+const XRA1405_Stats &XRA1405_stats(uint8_t chipSelectPin);
+void XRA1405_resetStats(uint8_t chipSelectPin);
+#endif
+
+// Enable the shadow register cache for a chip and populate it from the device.
+// Returns false if all XRA1405_MAX_DEVICES default devices are in use.
+bool XRA1405_enableCache(uint8_t chipSelectPin);
+
+// Disable the shadow register cache for a chip (setters go back to read-modify-write)
+void XRA1405_disableCache(uint8_t chipSelectPin);
+
+// Re-read every writable register into the shadow cache, e.g. after a suspected chip reset.
+// Returns false if the cache is not enabled for the chip.
+bool XRA1405_resyncCache(uint8_t chipSelectPin);
+
+// Snapshot the whole register file / write the writable part of a snapshot back, one transaction each
+void XRA1405_dumpRegisters(uint8_t chipSelectPin, XRA1405_RegisterMap &map, bool readState = true);
+void XRA1405_restoreRegisters(uint8_t chipSelectPin, const XRA1405_RegisterMap &map);
+
+// Check register pairs against the shadow cache and rewrite the ones a chip reset changed.
+// Returns the number of registers rewritten (0 if healthy or the cache is not enabled).
+uint8_t XRA1405_repairRegisters(uint8_t chipSelectPin, uint16_t pairs = XRA1405_CHECK_DEFAULT);
+
+template <uint8_t Pin>
+inline void XRA1405::write(uint8_t value)
+{
+    typedef XRA1405_Pin<Pin> PinBits;
+    Lock lock(*this);
+
+    uint8_t outputControlRegisterValue = readCachedRegister(PinBits::outputRegister);
+    writeCachedRegister(PinBits::outputRegister, value == HIGH ? (outputControlRegisterValue | PinBits::mask) : (outputControlRegisterValue & ~PinBits::mask));
+}
+
+template <uint8_t Pin>
+inline uint8_t XRA1405::read()
+{
+    typedef XRA1405_Pin<Pin> PinBits;
+    Lock lock(*this);
+
+    uint16_t gpioState;
+    if (readGatedState(1 << Pin, gpioState))
+    {
+        return (gpioState >> Pin) & 0x01;
+    }
+
+    transport().beginTransaction(_clock);
+    uint8_t gpioStateRegisterValue = readStateFrame(PinBits::stateRegister);
+    transport().endTransaction();
+    recordGpioState(Pin < 8 ? gpioStateRegisterValue : (uint16_t)(gpioStateRegisterValue << 8), Pin < 8 ? 0x00FF : 0xFF00);
+    return (gpioStateRegisterValue & PinBits::mask) ? HIGH : LOW;
+}
+
+template <uint8_t Pin>
+inline void XRA1405::toggle()
+{
+    typedef XRA1405_Pin<Pin> PinBits;
+    Lock lock(*this);
+
+    uint8_t outputControlRegisterValue = readCachedRegister(PinBits::outputRegister);
+    writeCachedRegister(PinBits::outputRegister, outputControlRegisterValue ^ PinBits::mask);
+}
+
+// Compile-time pin forms of XRA1405_digitalWrite/XRA1405_digitalRead, e.g. XRA1405_digitalWrite<3>(SS, HIGH)
+template <uint8_t Pin>
+inline void XRA1405_digitalWrite(uint8_t chipSelectPin, uint8_t value)
+{
+    XRA1405_device(chipSelectPin).write<Pin>(value);
+}
+
+template <uint8_t Pin>
+inline uint8_t XRA1405_digitalRead(uint8_t chipSelectPin)
+{
+    return XRA1405_device(chipSelectPin).read<Pin>();
+}
 
 #endif // XRA1405_HPP
\ No newline at end of file
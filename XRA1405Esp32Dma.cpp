@@ -0,0 +1,305 @@
+#include "XRA1405Esp32Dma.hpp"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <soc/gpio_reg.h>
+
+XRA1405_DmaBus::XRA1405_DmaBus(spi_host_device_t host)
+    : _host(host),
+      _handle(nullptr),
+      _slots(),
+      _transactions(),
+      _chipCount(0),
+      _inputs(nullptr),
+      _callback(nullptr),
+      _context(nullptr),
+      _notifyTask(nullptr),
+      _queued(0),
+      _completed(0),
+      _reclaimed(0),
+      _pending(false)
+{
+}
+
+bool XRA1405_DmaBus::begin(int8_t sck, int8_t miso, int8_t mosi, uint32_t freq)
+{
+    spi_bus_config_t busConfig;
+    memset(&busConfig, 0, sizeof(busConfig));
+    busConfig.mosi_io_num = mosi;
+    busConfig.miso_io_num = miso;
+    busConfig.sclk_io_num = sck;
+    busConfig.quadwp_io_num = -1;
+    busConfig.quadhd_io_num = -1;
+    busConfig.max_transfer_sz = 3; // Command byte plus one register pair
+
+    if (spi_bus_initialize(_host, &busConfig, SPI_DMA_CH_AUTO) != ESP_OK)
+    {
+        return false;
+    }
+
+    // One driver device for all chips; CS is selected per frame in the pre/post transfer hooks
+    spi_device_interface_config_t deviceConfig;
+    memset(&deviceConfig, 0, sizeof(deviceConfig));
+    deviceConfig.mode = 0;
+    deviceConfig.clock_speed_hz = XRA1405::validClock(freq);
+    deviceConfig.spics_io_num = -1;
+    deviceConfig.queue_size = XRA1405_DMA_MAX_CHIPS;
+    deviceConfig.pre_cb = beforeTransfer;
+    deviceConfig.post_cb = afterTransfer;
+
+    if (spi_bus_add_device(_host, &deviceConfig, &_handle) != ESP_OK)
+    {
+        spi_bus_free(_host);
+        return false;
+    }
+
+    return true;
+}
+
+void XRA1405_DmaBus::end()
+{
+    if (_handle != nullptr)
+    {
+        finish();
+        spi_bus_remove_device(_handle);
+        spi_bus_free(_host);
+        _handle = nullptr;
+    }
+}
+
+int8_t XRA1405_DmaBus::addChip(uint8_t chipSelectPin)
+{
+    if (_chipCount == XRA1405_DMA_MAX_CHIPS || _pending)
+    {
+        return -1;
+    }
+
+    // Deselect the chip before the first frame
+    pinMode(chipSelectPin, OUTPUT);
+    digitalWrite(chipSelectPin, HIGH);
+
+    Slot &slot = _slots[_chipCount];
+    slot.bus = this;
+    slot.index = _chipCount;
+    slot.chipSelectMask = 1UL << (chipSelectPin % 32);
+    slot.chipSelectSetRegister = (volatile uint32_t *)GPIO_OUT_W1TS_REG;
+    slot.chipSelectClearRegister = (volatile uint32_t *)GPIO_OUT_W1TC_REG;
+#if defined(GPIO_OUT1_W1TS_REG)
+    if (chipSelectPin >= 32)
+    {
+        slot.chipSelectSetRegister = (volatile uint32_t *)GPIO_OUT1_W1TS_REG;
+        slot.chipSelectClearRegister = (volatile uint32_t *)GPIO_OUT1_W1TC_REG;
+    }
+#endif
+    return _chipCount++;
+}
+
+bool XRA1405_DmaBus::startInputScan(uint16_t *inputs, XRA1405_DmaCallback callback, void *context)
+{
+    _inputs = inputs;
+    return start(GSR1 | XRA1405_READ, nullptr, callback, context);
+}
+
+bool XRA1405_DmaBus::startOutputWrite(const uint16_t *outputs, XRA1405_DmaCallback callback, void *context)
+{
+    _inputs = nullptr;
+    return start(OCR1 & XRA1405_WRITE, outputs, callback, context);
+}
+
+bool XRA1405_DmaBus::start(uint8_t commandByte, const uint16_t *outputs, XRA1405_DmaCallback callback, void *context)
+{
+    if (_handle == nullptr || _pending || _chipCount == 0)
+    {
+        return false;
+    }
+
+    _callback = callback;
+    _context = context;
+    _completed = 0;
+    _reclaimed = 0;
+    _queued = _chipCount;
+    _pending = true;
+
+    for (uint8_t i = 0; i < _chipCount; i++)
+    {
+        // Three bytes fit the transaction's inline buffers, nothing has to be allocated per frame
+        spi_transaction_t &transaction = _transactions[i];
+        memset(&transaction, 0, sizeof(transaction));
+        transaction.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+        transaction.length = 24;
+        transaction.tx_data[0] = commandByte;
+        transaction.tx_data[1] = outputs != nullptr ? (outputs[i] & 0xFF) : 0x00;
+        transaction.tx_data[2] = outputs != nullptr ? (outputs[i] >> 8) : 0x00;
+        transaction.user = &_slots[i];
+
+        if (spi_device_queue_trans(_handle, &transaction, portMAX_DELAY) != ESP_OK)
+        {
+            // Frames already queued still complete and are reclaimed by finish(). They can never make
+            // _completed reach _chipCount, so the ISR does not announce this scan.
+            _queued = i;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool XRA1405_DmaBus::finish(TickType_t timeout)
+{
+    if (!_pending)
+    {
+        return true;
+    }
+
+    while (_reclaimed < _queued)
+    {
+        spi_transaction_t *done;
+        if (spi_device_get_trans_result(_handle, &done, timeout) != ESP_OK)
+        {
+            return false; // Still owned by the driver, call finish() again
+        }
+        _reclaimed++;
+    }
+
+    _pending = false;
+    return true;
+}
+
+void IRAM_ATTR XRA1405_DmaBus::beforeTransfer(spi_transaction_t *transaction)
+{
+    Slot *slot = static_cast<Slot *>(transaction->user);
+    *slot->chipSelectClearRegister = slot->chipSelectMask;
+}
+
+void IRAM_ATTR XRA1405_DmaBus::afterTransfer(spi_transaction_t *transaction)
+{
+    Slot *slot = static_cast<Slot *>(transaction->user);
+    XRA1405_DmaBus *bus = slot->bus;
+    *slot->chipSelectSetRegister = slot->chipSelectMask;
+
+    if (bus->_inputs != nullptr)
+    {
+        bus->_inputs[slot->index] = (uint16_t)(transaction->rx_data[2] << 8) | transaction->rx_data[1];
+    }
+
+    // Compared with _chipCount, not _queued: a failing start() lowers _queued while frames complete
+    if (++bus->_completed != bus->_chipCount)
+    {
+        return;
+    }
+
+    // Last frame of the scan
+    if (bus->_callback != nullptr)
+    {
+        bus->_callback(bus->_context);
+    }
+    if (bus->_notifyTask != nullptr)
+    {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(bus->_notifyTask, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken == pdTRUE)
+        {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+XRA1405_IdfTransport::XRA1405_IdfTransport(spi_host_device_t host, uint8_t chipSelectPin)
+    : _host(host),
+      _handle(nullptr),
+      _chipSelectPin(chipSelectPin),
+      _clock(0)
+{
+}
+
+XRA1405_IdfTransport::~XRA1405_IdfTransport()
+{
+    removeDevice();
+}
+
+void XRA1405_IdfTransport::begin()
+{
+    // The driver takes CS high as soon as the device is added
+    if (_handle == nullptr)
+    {
+        addDevice(XRA1405_SPI_CLOCK);
+    }
+}
+
+void XRA1405_IdfTransport::beginTransaction(uint32_t clock)
+{
+    if (_handle == nullptr || clock != _clock)
+    {
+        removeDevice();
+        addDevice(clock);
+    }
+    if (_handle != nullptr)
+    {
+        spi_device_acquire_bus(_handle, portMAX_DELAY);
+    }
+}
+
+void XRA1405_IdfTransport::endTransaction()
+{
+    if (_handle != nullptr)
+    {
+        spi_device_release_bus(_handle);
+    }
+}
+
+void XRA1405_IdfTransport::transfer(uint8_t *data, uint8_t length)
+{
+    if (_handle == nullptr)
+    {
+        memset(data, 0, length);
+        return;
+    }
+
+    spi_transaction_t transaction;
+    memset(&transaction, 0, sizeof(transaction));
+    transaction.length = length * 8;
+
+    // The driver's frames are at most three bytes and fit the inline buffers
+    if (length <= sizeof(transaction.tx_data))
+    {
+        transaction.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+        memcpy(transaction.tx_data, data, length);
+        spi_device_polling_transmit(_handle, &transaction);
+        memcpy(data, transaction.rx_data, length);
+    }
+    else
+    {
+        transaction.tx_buffer = data;
+        transaction.rx_buffer = data;
+        spi_device_polling_transmit(_handle, &transaction);
+    }
+}
+
+bool XRA1405_IdfTransport::addDevice(uint32_t clock)
+{
+    spi_device_interface_config_t deviceConfig;
+    memset(&deviceConfig, 0, sizeof(deviceConfig));
+    deviceConfig.mode = 0;
+    deviceConfig.clock_speed_hz = XRA1405::validClock(clock);
+    deviceConfig.spics_io_num = _chipSelectPin;
+    deviceConfig.queue_size = 1;
+
+    if (spi_bus_add_device(_host, &deviceConfig, &_handle) != ESP_OK)
+    {
+        _handle = nullptr;
+        return false;
+    }
+    _clock = clock;
+    return true;
+}
+
+void XRA1405_IdfTransport::removeDevice()
+{
+    if (_handle != nullptr)
+    {
+        spi_bus_remove_device(_handle);
+        _handle = nullptr;
+    }
+}
+
+#endif // ARDUINO_ARCH_ESP32
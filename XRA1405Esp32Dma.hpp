@@ -0,0 +1,144 @@
+/**
+ * @file
+ *    XRA1405 ESP32 Background Bus
+ *
+ * @brief
+ *    Non-blocking access to many XRA1405 chips through the ESP-IDF spi_master driver (ESP32 only).
+ *    A scan queues one paired GSR1/GSR2 read per chip and returns immediately; the driver runs the
+ *    frames from its interrupt and the last one signals completion through a callback and/or a
+ *    FreeRTOS task notification, so the calling core is free while the bus works.
+ *
+ *    The bus owns the SPI host it is given; do not use the same host through SPIClass at the same time.
+ *    CS lines are driven by the driver's pre/post transfer hooks, so more chips than the host's three
+ *    hardware CS lines can share one bus. Frames always use paired register access (see XRA1405.hpp).
+ *
+ *    XRA1405_IdfTransport puts a single XRA1405 on the same driver, so the whole device API runs over
+ *    spi_master instead of SPIClass. It adds its own driver device with the chip's CS as a hardware CS
+ *    line, which limits a host to three of them.
+ *
+ * Usage and Examples:
+ *      `XRA1405_DmaBus expanders(SPI3_HOST);`
+ *      `expanders.begin(SCK, MISO, MOSI);`
+ *      `expanders.addChip(5);`
+ *      `expanders.addChip(17);`
+ *      `uint16_t inputs[2];`
+ *      `expanders.setNotifyTask(xTaskGetCurrentTaskHandle());`
+ *      `expanders.startInputScan(inputs);`
+ *      `ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // The control loop could run here instead`
+ *      `expanders.finish();`
+ *
+ *      `XRA1405_IdfTransport link(SPI3_HOST, 21); // Host already started, e.g. by expanders.begin()`
+ *      `XRA1405 expander(link);`
+ *      `expander.begin(true);`
+ */
+
+#ifndef XRA1405_ESP32_DMA_HPP
+#define XRA1405_ESP32_DMA_HPP
+
+#include "XRA1405.hpp"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <driver/spi_master.h>
+
+// Number of chips one XRA1405_DmaBus can scan
+#ifndef XRA1405_DMA_MAX_CHIPS
+#define XRA1405_DMA_MAX_CHIPS 16
+#endif
+
+// Called once every queued frame of a scan or write finished. Runs in interrupt context: keep it short.
+typedef void (*XRA1405_DmaCallback)(void *context);
+
+class XRA1405_DmaBus
+{
+public:
+    explicit XRA1405_DmaBus(spi_host_device_t host);
+
+    // Initialize the SPI host with DMA. Returns false if the driver rejected the configuration.
+    bool begin(int8_t sck, int8_t miso, int8_t mosi, uint32_t freq = XRA1405_SPI_CLOCK);
+    void end();
+
+    // Add a chip by its CS pin. Returns its index in scan results, or -1 if the bus is full.
+    int8_t addChip(uint8_t chipSelectPin);
+
+    // Queue a GSR1/GSR2 read for every chip; inputs[i] is filled for chip i by the time the scan completes
+    bool startInputScan(uint16_t *inputs, XRA1405_DmaCallback callback = nullptr, void *context = nullptr);
+
+    // Queue an OCR1/OCR2 write for every chip, outputs[i] goes to chip i (copied before returning)
+    bool startOutputWrite(const uint16_t *outputs, XRA1405_DmaCallback callback = nullptr, void *context = nullptr);
+
+    // Wait for the queued frames and hand them back to the driver. Must be called before the next start.
+    // Returns false if timeout ran out first; calling it again waits only for the frames still out.
+    bool finish(TickType_t timeout = portMAX_DELAY);
+
+    // True while queued frames have not all completed
+    bool busy() const { return _completed != _queued; }
+
+    // Send a FreeRTOS task notification when a scan or write completes
+    void setNotifyTask(TaskHandle_t task) { _notifyTask = task; }
+
+    uint8_t size() const { return _chipCount; }
+
+private:
+    // Per-chip context of a queued frame. CS is driven through the GPIO set/clear registers, resolved in
+    // addChip(): the hooks run in the SPI ISR, which is placed in IRAM and must not call into flash.
+    struct Slot
+    {
+        XRA1405_DmaBus *bus;
+        volatile uint32_t *chipSelectSetRegister;
+        volatile uint32_t *chipSelectClearRegister;
+        uint32_t chipSelectMask;
+        uint8_t index;
+    };
+
+    bool start(uint8_t commandByte, const uint16_t *outputs, XRA1405_DmaCallback callback, void *context);
+
+    static void beforeTransfer(spi_transaction_t *transaction);
+    static void afterTransfer(spi_transaction_t *transaction);
+
+    spi_host_device_t _host;
+    spi_device_handle_t _handle;
+    Slot _slots[XRA1405_DMA_MAX_CHIPS];
+    spi_transaction_t _transactions[XRA1405_DMA_MAX_CHIPS];
+    uint8_t _chipCount;
+
+    uint16_t *_inputs;
+    XRA1405_DmaCallback _callback;
+    void *_context;
+    TaskHandle_t _notifyTask;
+    uint8_t _queued; // Frames finish() has to reclaim
+    volatile uint8_t _completed;
+    uint8_t _reclaimed; // Results finish() has already taken back from the driver
+    bool _pending;      // Transactions queued and not yet reclaimed by finish()
+};
+
+// One chip on an ESP-IDF SPI host started elsewhere (XRA1405_DmaBus::begin() or spi_bus_initialize()).
+// Frames are polled transactions with the bus acquired for the whole XRA1405 transaction, so chips on
+// it cannot join an XRA1405_Group or XRA1405_Matrix sweep, which frame several chips in one transaction.
+// busKey() is the transport itself, so XRA1405_Group::begin() rejects a group built from two of them;
+// the driver already serializes devices on one host.
+class XRA1405_IdfTransport : public XRA1405_Transport
+{
+public:
+    XRA1405_IdfTransport(spi_host_device_t host, uint8_t chipSelectPin);
+    ~XRA1405_IdfTransport();
+
+    void begin();
+    void beginTransaction(uint32_t clock);
+    void endTransaction();
+    void transfer(uint8_t *data, uint8_t length);
+
+private:
+    // (Re)register the driver device; the driver fixes the clock when a device is added
+    bool addDevice(uint32_t clock);
+    void removeDevice();
+
+    spi_host_device_t _host;
+    spi_device_handle_t _handle;
+    uint8_t _chipSelectPin;
+    uint32_t _clock;
+};
+
+#endif // ARDUINO_ARCH_ESP32
+
+#endif // XRA1405_ESP32_DMA_HPP
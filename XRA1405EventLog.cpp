@@ -0,0 +1,64 @@
+#include "XRA1405EventLog.hpp"
+
+#if XRA1405_HAS_ATOMIC
+
+XRA1405_EventLog::XRA1405_EventLog()
+    : _dropped(0),
+      _slots(),
+      _slotCount(0)
+{
+}
+
+bool XRA1405_EventLog::attach(XRA1405 &device, uint8_t irqPin, uint8_t chip)
+{
+    if (_slotCount == XRA1405_EVENTLOG_MAX_CHIPS)
+    {
+        return false;
+    }
+
+    Slot &slot = _slots[_slotCount++];
+    slot.log = this;
+    slot.chip = chip;
+    device.attachInterrupt(irqPin, recordInterrupt, &slot);
+    return true;
+}
+
+bool XRA1405_EventLog::record(uint8_t chip, uint16_t changedMask, uint16_t state, uint32_t timestamp)
+{
+    XRA1405_Event event;
+    event.timestamp = timestamp;
+    event.changedMask = changedMask;
+    event.state = state;
+    event.chip = chip;
+
+    if (!_events.push(event))
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void XRA1405_EventLog::recordScan(uint8_t chip, uint16_t changedMask, uint16_t state, void *context)
+{
+    static_cast<XRA1405_EventLog *>(context)->record(chip, changedMask, state, micros());
+}
+
+uint16_t XRA1405_EventLog::drain(XRA1405_Event *events, uint16_t maxEvents)
+{
+    uint16_t count = 0;
+    while (count < maxEvents && _events.pop(events[count]))
+    {
+        count++;
+    }
+    return count;
+}
+
+void XRA1405_EventLog::recordInterrupt(XRA1405 &device, uint16_t changedMask, uint16_t state, void *context)
+{
+    // Stamped by the host ISR at the IRQ# edge, not now
+    Slot *slot = static_cast<Slot *>(context);
+    slot->log->record(slot->chip, changedMask, state, device.interruptMicros());
+}
+
+#endif // XRA1405_HAS_ATOMIC
@@ -0,0 +1,100 @@
+/**
+ * @file
+ *    XRA1405 Event Log
+ *
+ * @brief
+ *    Timestamped capture of input changes into a preallocated XRA1405_Ring, drained by a consumer task
+ *    whenever it gets to it. A record is (timestamp, chip, changed pins, 16-bit state); recording is a
+ *    single lock-free push, never allocates and never blocks, so it is safe from the change callback,
+ *    a scanner callback, another task or an ISR.
+ *
+ *    Changes can come from two places:
+ *    - attach() installs the log as a chip's IRQ# change callback. The timestamp is the one the host
+ *      ISR took at the IRQ# edge (XRA1405::interruptMicros()), not the moment serviceInterrupts() ran.
+ *      Edges on the same pin between two services collapse into one record, as they do in ISR1/ISR2.
+ *    - recordScan() matches XRA1405_ScanCallback, so an XRA1405_Scanner can log its debounced changes.
+ *      Those are timestamped when the scan reports them.
+ *
+ *    A full ring drops the new record and counts it in dropped(); size the ring with
+ *    XRA1405_EVENTLOG_CAPACITY for the peak edge rate times the longest gap between drains.
+ *
+ *    Built where XRA1405_HAS_ATOMIC is set (see XRA1405Ring.hpp): the ESP32 and host builds by default.
+ *
+ * Usage and Examples:
+ *      `XRA1405_EventLog events;`
+ *      `events.attach(expander, 4, 0); // IRQ# on host pin 4, logged as chip 0`
+ *      `void loop() { expander.serviceInterrupts(); }`
+ *      `XRA1405_Event event; // Consumer task:`
+ *      `while (events.pop(event)) { Serial.println(event.timestamp); }`
+ */
+
+#ifndef XRA1405_EVENT_LOG_HPP
+#define XRA1405_EVENT_LOG_HPP
+
+#include "XRA1405.hpp"
+#include "XRA1405Ring.hpp"
+
+#if XRA1405_HAS_ATOMIC
+
+// Records the ring holds (power of two)
+#ifndef XRA1405_EVENTLOG_CAPACITY
+#define XRA1405_EVENTLOG_CAPACITY 256
+#endif
+
+// Chips one log can take IRQ# change callbacks from
+#ifndef XRA1405_EVENTLOG_MAX_CHIPS
+#define XRA1405_EVENTLOG_MAX_CHIPS 16
+#endif
+
+struct XRA1405_Event
+{
+    uint32_t timestamp;   // micros()
+    uint16_t changedMask; // Pins reported by ISR1/ISR2 or by the scanner
+    uint16_t state;       // GSR1/GSR2 (debounced levels for scanner records)
+    uint8_t chip;         // Caller-chosen chip number
+};
+
+class XRA1405_EventLog
+{
+public:
+    XRA1405_EventLog();
+
+    // Bind a chip's IRQ# to a host pin with the log as its change callback (replaces any other callback).
+    // Returns false if XRA1405_EVENTLOG_MAX_CHIPS chips are already attached.
+    bool attach(XRA1405 &device, uint8_t irqPin, uint8_t chip);
+
+    // Add one record. Returns false, counting a drop, if the ring is full.
+    bool record(uint8_t chip, uint16_t changedMask, uint16_t state, uint32_t timestamp);
+
+    // Scanner callback; pass the log as the context: `scanner.begin(XRA1405_EventLog::recordScan, &events)`
+    static void recordScan(uint8_t chip, uint16_t changedMask, uint16_t state, void *context);
+
+    // Oldest record first. Single consumer only.
+    bool pop(XRA1405_Event &event) { return _events.pop(event); }
+
+    // Copy up to maxEvents records into events, returns how many were copied
+    uint16_t drain(XRA1405_Event *events, uint16_t maxEvents);
+
+    bool empty() const { return _events.empty(); }
+
+    // Records lost to a full ring since construction
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        XRA1405_EventLog *log;
+        uint8_t chip;
+    };
+
+    static void recordInterrupt(XRA1405 &device, uint16_t changedMask, uint16_t state, void *context);
+
+    XRA1405_Ring<XRA1405_Event, XRA1405_EVENTLOG_CAPACITY> _events;
+    std::atomic<uint32_t> _dropped;
+    Slot _slots[XRA1405_EVENTLOG_MAX_CHIPS];
+    uint8_t _slotCount;
+};
+
+#endif // XRA1405_HAS_ATOMIC
+
+#endif // XRA1405_EVENT_LOG_HPP
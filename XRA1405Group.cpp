@@ -0,0 +1,159 @@
+#include "XRA1405Group.hpp"
+
+XRA1405_Group::XRA1405_Group(XRA1405 *const *devices, uint8_t count)
+    : _devices(devices),
+      _count(count)
+{
+}
+
+bool XRA1405_Group::begin(bool useCache)
+{
+    // One transaction cannot span two buses; refuse rather than frame chips on a bus nobody holds
+    for (uint8_t i = 1; i < _count; i++)
+    {
+        if (_devices[i]->transport().busKey() != _devices[0]->transport().busKey())
+        {
+            _count = 0;
+            return false;
+        }
+    }
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        _devices[i]->begin(useCache);
+    }
+    return true;
+}
+
+void XRA1405_Group::writeOutputs(const uint16_t *values)
+{
+    if (_count == 0)
+    {
+        return;
+    }
+
+    BusTransaction transaction(*_devices[0]);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        _devices[i]->writeFrame16(OCR1, values[i]);
+    }
+}
+
+void XRA1405_Group::modifyOutputs(const uint16_t *andMasks, const uint16_t *xorMasks)
+{
+    modifyOutputs(andMasks, xorMasks, _count);
+}
+
+void XRA1405_Group::modifyOutputs(const uint16_t *andMasks, const uint16_t *xorMasks, uint8_t count)
+{
+    if (count > _count)
+    {
+        count = _count;
+    }
+
+    // Chips whose masks change nothing are left off the bus, the whole transaction too if that is all of them
+    uint8_t touchedChips = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if ((uint16_t)(~andMasks[i] | xorMasks[i]) != 0)
+        {
+            touchedChips++;
+        }
+    }
+    if (touchedChips == 0)
+    {
+        return;
+    }
+
+    BusTransaction transaction(*_devices[0]);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t touchedBits = ~andMasks[i] | xorMasks[i];
+        if (touchedBits == 0)
+        {
+            continue;
+        }
+
+        XRA1405 &device = *_devices[i];
+        uint16_t outputControlValue = device.readCachedFrame16(OCR1);
+        outputControlValue = (outputControlValue & andMasks[i]) ^ xorMasks[i];
+
+        // Like XRA1405::modifyPort(), a half of the port the masks leave alone is not written
+        if ((touchedBits & 0x00FF) == 0 || (touchedBits & 0xFF00) == 0)
+        {
+            uint8_t registerCommand = (touchedBits & 0x00FF) ? OCR1 : OCR2;
+            uint8_t value = (registerCommand == OCR1) ? (outputControlValue & 0xFF) : (outputControlValue >> 8);
+            uint8_t buffer[2] = {(uint8_t)(registerCommand & XRA1405_WRITE), value};
+            device.transferFrame(buffer, 2);
+            device.updateShadow(registerCommand, value);
+        }
+        else
+        {
+            device.writeFrame16(OCR1, outputControlValue);
+        }
+    }
+}
+
+void XRA1405_Group::readInputs(uint16_t *values)
+{
+    readInputs(values, _count);
+}
+
+void XRA1405_Group::readInputs(uint16_t *values, uint8_t count)
+{
+    if (count > _count)
+    {
+        count = _count;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    BusTransaction transaction(*_devices[0]);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        values[i] = _devices[i]->readStateFrame16();
+        _devices[i]->recordGpioState(values[i], 0xFFFF);
+    }
+}
+
+void XRA1405_Group::configure(const XRA1405_Config &config)
+{
+    if (_count == 0)
+    {
+        return;
+    }
+
+    BusTransaction transaction(*_devices[0]);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        _devices[i]->writeConfigFrames(config);
+    }
+}
+
+void XRA1405_Group::configure(const XRA1405_Config *configs)
+{
+    if (_count == 0)
+    {
+        return;
+    }
+
+    BusTransaction transaction(*_devices[0]);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        _devices[i]->writeConfigFrames(configs[i]);
+    }
+}
+
+XRA1405_Group::BusTransaction::BusTransaction(XRA1405 &first)
+    : _lock(first),
+      _first(first)
+{
+    _first.transport().beginTransaction(_first._clock);
+}
+
+XRA1405_Group::BusTransaction::~BusTransaction()
+{
+    _first.transport().endTransaction();
+}
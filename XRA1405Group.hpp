@@ -0,0 +1,83 @@
+/**
+ * @file
+ *    XRA1405 Chip Group
+ *
+ * @brief
+ *    Group-wide operations for several XRA1405 chips sharing one SPI bus. Every operation takes the bus
+ *    once and toggles the chip select pins back to back, so a full I/O snapshot costs one transaction
+ *    no matter how many chips the group holds.
+ *
+ *    All devices in a group must be on one bus, i.e. report the same XRA1405_Transport::busKey(): the
+ *    same SPIClass, or mock transports built on one XRA1405_MockBus. The transaction is opened on the
+ *    first device's transport at its clock, then every chip sends its frames inside it.
+ *
+ * Usage and Examples:
+ *      `XRA1405 chips[] = {XRA1405(5), XRA1405(17), XRA1405(16)};`
+ *      `XRA1405 *devices[] = {&chips[0], &chips[1], &chips[2]};`
+ *      `XRA1405_Group group(devices, 3);`
+ *      `group.begin();`
+ *      `uint16_t inputs[3];`
+ *      `group.readInputs(inputs); // inputs[i] bit n = pin n of chip i`
+ */
+
+#ifndef XRA1405_GROUP_HPP
+#define XRA1405_GROUP_HPP
+
+#include "XRA1405.hpp"
+
+class XRA1405_Group
+{
+public:
+    // The device array must outlive the group
+    XRA1405_Group(XRA1405 *const *devices, uint8_t count);
+
+    // Configure the chip select pins and optionally populate each device's shadow cache.
+    // Returns false, and empties the group so every operation is a no-op, if the devices are not all
+    // on one bus.
+    bool begin(bool useCache = false);
+
+    // Write all outputs, values[i] goes to OCR1/OCR2 of chip i
+    void writeOutputs(const uint16_t *values);
+
+    // Set the outputs of chip i to (outputs & andMasks[i]) ^ xorMasks[i], all chips in one transaction.
+    // Current outputs come from each device's shadow cache, or are read back inside the same transaction.
+    // Chips (and port halves) the masks leave unchanged get no frame.
+    void modifyOutputs(const uint16_t *andMasks, const uint16_t *xorMasks);
+
+    // Same for the first count chips only (clamped to size()), the mask arrays need count entries
+    void modifyOutputs(const uint16_t *andMasks, const uint16_t *xorMasks, uint8_t count);
+
+    // Read all inputs, values[i] receives GSR1/GSR2 of chip i
+    void readInputs(uint16_t *values);
+
+    // Same for the first count chips only (clamped to size()), values needs count entries
+    void readInputs(uint16_t *values, uint8_t count);
+
+    // Write the same configuration to every chip
+    void configure(const XRA1405_Config &config);
+
+    // Write one configuration per chip, configs[i] goes to chip i
+    void configure(const XRA1405_Config *configs);
+
+    uint8_t size() const { return _count; }
+    XRA1405 &device(uint8_t index) const { return *_devices[index]; }
+
+private:
+    // Holds the bus for one group operation. All devices share the bus, so the first device's mutex
+    // and transport cover the whole group: the lock is taken, then the transaction opened at its clock.
+    class BusTransaction
+    {
+    public:
+        explicit BusTransaction(XRA1405 &first);
+        ~BusTransaction();
+
+    private:
+        XRA1405::Lock _lock;
+        XRA1405 &_first;
+    };
+
+    XRA1405 *const *_devices;
+    uint8_t _count;
+};
+
+#endif // XRA1405_GROUP_HPP
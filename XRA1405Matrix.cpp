@@ -0,0 +1,156 @@
+#include "XRA1405Matrix.hpp"
+
+XRA1405_Matrix::XRA1405_Matrix(XRA1405 &device, uint8_t rows, uint8_t columns, uint16_t periodMillis)
+    : _device(device),
+      _rows(rows > 8 ? 8 : rows),
+      _rowMask((uint8_t)((1u << (rows > 8 ? 8 : rows)) - 1)),
+      _columnMask((uint8_t)((1u << (columns > 8 ? 8 : columns)) - 1)),
+      _settleMicros(0),
+      _periodMillis(periodMillis),
+      _lastScan(0),
+      _callback(nullptr),
+      _context(nullptr),
+      _stable(0),
+      _counterLow(0),
+      _counterHigh(0),
+      _changes(0),
+      _ghostedScans(0)
+{
+}
+
+void XRA1405_Matrix::begin(XRA1405_KeyCallback callback, void *context)
+{
+    _callback = callback;
+    _context = context;
+
+    XRA1405::Lock lock(_device);
+
+    // Rows: outputs driving low, all released until selected
+    uint16_t rowBits = _rowMask;
+    uint16_t columnBits = (uint16_t)_columnMask << 8;
+    uint16_t threeStateValue = _device.readCachedRegister16(TSCR1);
+    _device.writeCachedRegister16(TSCR1, threeStateValue | rowBits);
+    _device.writeCachedRegister16(OCR1, _device.readCachedRegister16(OCR1) & ~rowBits);
+
+    // Columns: inputs with pull-ups, read as low while a key connects them to the selected row
+    _device.writeCachedRegister16(PUR1, _device.readCachedRegister16(PUR1) | columnBits);
+    _device.writeCachedRegister16(GCR1, (_device.readCachedRegister16(GCR1) & ~rowBits) | columnBits);
+
+    _stable = 0;
+    _counterLow = 0;
+    _counterHigh = 0;
+    _changes = 0;
+    _ghostedScans = 0;
+    _lastScan = millis();
+}
+
+bool XRA1405_Matrix::poll()
+{
+    uint32_t now = millis();
+    if (now - _lastScan < _periodMillis)
+    {
+        return false;
+    }
+    _lastScan = now;
+    return scan();
+}
+
+bool XRA1405_Matrix::scan()
+{
+    uint8_t columnsPerRow[8] = {0};
+    sweep(columnsPerRow);
+
+    if (hasGhosts(columnsPerRow))
+    {
+        _ghostedScans++;
+        return false;
+    }
+
+    uint64_t sample = 0;
+    for (uint8_t row = 0; row < _rows; row++)
+    {
+        sample |= (uint64_t)columnsPerRow[row] << (row * 8);
+    }
+
+    // Same two-bit vertical counter as XRA1405_Scanner, on 64 keys at once
+    uint64_t delta = sample ^ _stable;
+    _counterHigh = (_counterHigh ^ _counterLow) & delta;
+    _counterLow = ~_counterLow & delta;
+
+    uint64_t toggled = _counterHigh & _counterLow;
+    if (toggled == 0)
+    {
+        return false;
+    }
+
+    _stable ^= toggled;
+    _counterLow &= ~toggled;
+    _counterHigh &= ~toggled;
+    _changes |= toggled;
+
+    if (_callback != nullptr)
+    {
+        for (uint8_t key = 0; key < 64; key++)
+        {
+            if ((toggled >> key) & 1)
+            {
+                _callback(key, (_stable >> key) & 1, _context);
+            }
+        }
+    }
+    return true;
+}
+
+uint64_t XRA1405_Matrix::takeChanges()
+{
+    uint64_t changes = _changes;
+    _changes = 0;
+    return changes;
+}
+
+void XRA1405_Matrix::sweep(uint8_t *columnsPerRow)
+{
+    XRA1405::Lock lock(_device);
+
+    // Non-row pins keep their current TSCR1 bits, whatever was set since begin()
+    uint8_t allReleased = _device.readCachedRegister(TSCR1) | _rowMask;
+
+    _device.transport().beginTransaction(_device._clock);
+    for (uint8_t row = 0; row < _rows; row++)
+    {
+        // Select the row by letting only it drive its low level
+        uint8_t selectFrame[2] = {(uint8_t)(TSCR1 & XRA1405_WRITE), (uint8_t)(allReleased & ~(1 << row))};
+        _device.transferFrame(selectFrame, 2);
+
+        if (_settleMicros != 0)
+        {
+            delayMicroseconds(_settleMicros);
+        }
+
+        // Pressed keys pull their column low
+        columnsPerRow[row] = (uint8_t)~_device.readStateFrame(GSR2) & _columnMask;
+    }
+
+    uint8_t releaseFrame[2] = {(uint8_t)(TSCR1 & XRA1405_WRITE), allReleased};
+    _device.transferFrame(releaseFrame, 2);
+    _device.transport().endTransaction();
+
+    _device.updateShadow(TSCR1, allReleased);
+}
+
+bool XRA1405_Matrix::hasGhosts(const uint8_t *columnsPerRow) const
+{
+    // Two rows sharing at least two columns form a rectangle; any one of its four keys may be a ghost
+    for (uint8_t first = 0; first < _rows; first++)
+    {
+        for (uint8_t second = first + 1; second < _rows; second++)
+        {
+            uint8_t shared = columnsPerRow[first] & columnsPerRow[second];
+            if (shared & (shared - 1))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file
+ *    XRA1405 Key Matrix Scanner
+ *
+ * @brief
+ *    Scans a keypad or switch matrix of up to 8x8 keys wired to one chip: rows on P0-P7, columns on
+ *    P8-P15 with the internal pull-ups. A full sweep is a single bus transaction of one TSCR1 write to
+ *    select a row and one GSR2 read of all columns per row, so each row read is pipelined behind
+ *    its select.
+ *
+ *    Rows are outputs held low and selected by taking them out of three-state, so an unselected row
+ *    floats instead of driving high. Two keys pressed in the same column therefore never short two
+ *    row drivers, even without diodes.
+ *
+ *    Key n (row * 8 + column) is bit n of a 64-bit map. Keys are debounced with a two-bit vertical
+ *    counter and change after XRA1405_MATRIX_STABLE_SAMPLES identical sweeps. If a sweep shows a
+ *    rectangle of pressed keys (two rows sharing two or more columns), a diode-less matrix cannot tell
+ *    which of them are real. Such a sweep is dropped and counted in ghostedScans().
+ *
+ * Usage and Examples:
+ *      `XRA1405_Matrix keypad(expander, 4, 4); // 4 rows on P0-P3, 4 columns on P8-P11`
+ *      `void onKey(uint8_t key, bool pressed, void *context) { ... }`
+ *      `keypad.begin(onKey);`
+ *      `void loop() { keypad.poll(); }`
+ */
+
+#ifndef XRA1405_MATRIX_HPP
+#define XRA1405_MATRIX_HPP
+
+#include "XRA1405.hpp"
+
+// Consecutive identical sweeps before a key change is reported (fixed by the two-bit vertical counter)
+#define XRA1405_MATRIX_STABLE_SAMPLES 3
+
+// Key change callback, key = row * 8 + column
+typedef void (*XRA1405_KeyCallback)(uint8_t key, bool pressed, void *context);
+
+class XRA1405_Matrix
+{
+public:
+    // The device must outlive the scanner. rows and columns are 1-8.
+    XRA1405_Matrix(XRA1405 &device, uint8_t rows = 8, uint8_t columns = 8, uint16_t periodMillis = 5);
+
+    // Configure the row and column pins (other pins are left alone) and start from "no key pressed"
+    void begin(XRA1405_KeyCallback callback = nullptr, void *context = nullptr);
+
+    // Wait this long after selecting a row before its columns are read (long wires, slow pull-ups)
+    void setSettleMicros(uint8_t settleMicros) { _settleMicros = settleMicros; }
+
+    void setPeriod(uint16_t periodMillis) { _periodMillis = periodMillis; }
+
+    // Sweep if the period has elapsed since the last sweep. Returns true if any key changed.
+    bool poll();
+
+    // Sweep now, regardless of the period
+    bool scan();
+
+    // Debounced key map, bit row * 8 + column
+    uint64_t state() const { return _stable; }
+    bool pressed(uint8_t row, uint8_t column) const { return (_stable >> (row * 8 + column)) & 1; }
+
+    // Keys that changed since the last call
+    uint64_t takeChanges();
+
+    // Sweeps dropped because of a possible ghost key
+    uint32_t ghostedScans() const { return _ghostedScans; }
+
+private:
+    void sweep(uint8_t *columnsPerRow);
+    bool hasGhosts(const uint8_t *columnsPerRow) const;
+
+    XRA1405 &_device;
+    uint8_t _rows;
+    uint8_t _rowMask;
+    uint8_t _columnMask;
+    uint8_t _settleMicros;
+    uint16_t _periodMillis;
+    uint32_t _lastScan;
+    XRA1405_KeyCallback _callback;
+    void *_context;
+
+    uint64_t _stable;
+    uint64_t _counterLow;
+    uint64_t _counterHigh;
+    uint64_t _changes;
+    uint32_t _ghostedScans;
+};
+
+#endif // XRA1405_MATRIX_HPP
@@ -0,0 +1,197 @@
+#include "XRA1405Mock.hpp"
+
+// Register reset values by address (datasheet Table 2): OCR, GCR and IFR come up as 0xFF
+static const uint8_t resetValues[XRA1405_REGISTER_COUNT] = {
+    0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF};
+
+XRA1405_MockTransport::XRA1405_MockTransport()
+    : _ownBus(),
+      _bus(&_ownBus),
+      _registers(),
+      _inputs(0),
+      _keys(0),
+      _maxClock(0xFFFFFFFF)
+{
+    reset();
+    resetCounters();
+}
+
+XRA1405_MockTransport::XRA1405_MockTransport(XRA1405_MockBus &bus)
+    : _ownBus(),
+      _bus(&bus),
+      _registers(),
+      _inputs(0),
+      _keys(0),
+      _maxClock(0xFFFFFFFF)
+{
+    reset();
+    resetCounters();
+}
+
+void XRA1405_MockTransport::begin()
+{
+}
+
+void XRA1405_MockTransport::beginTransaction(uint32_t clock)
+{
+    _bus->clock = clock;
+    _bus->transactionDepth++;
+    _bus->transactions++;
+}
+
+void XRA1405_MockTransport::endTransaction()
+{
+    if (_bus->transactionDepth > 0)
+    {
+        _bus->transactionDepth--;
+    }
+}
+
+void XRA1405_MockTransport::transfer(uint8_t *data, uint8_t length)
+{
+    _frames++;
+    _bytes += length;
+    _busNanos += (uint64_t)length * 8 * 1000000000ULL / _bus->clock;
+    if (_bus->transactionDepth == 0)
+    {
+        _strayFrames++;
+    }
+    if (length == 0)
+    {
+        return;
+    }
+
+    bool read = (data[0] & XRA1405_READ) != 0;
+    uint8_t address = (data[0] >> 1) & 0x3F;
+    data[0] = 0x00; // Nothing is shifted out during the command byte
+
+    // Data bytes alternate between the addressed register and the other one of its pair
+    for (uint8_t i = 1; i < length; i++)
+    {
+        uint8_t registerAddress = (i & 1) ? address : (address ^ 1);
+        if (registerAddress >= XRA1405_REGISTER_COUNT)
+        {
+            data[i] = 0x00;
+        }
+        else if (read)
+        {
+            data[i] = readAddress(registerAddress);
+            if (_bus->clock > _maxClock)
+            {
+                data[i] ^= 0x01;
+            }
+        }
+        else
+        {
+            writeAddress(registerAddress, data[i]);
+            data[i] = 0x00;
+        }
+    }
+}
+
+void XRA1405_MockTransport::reset()
+{
+    memcpy(_registers, resetValues, sizeof(_registers));
+    _inputs = 0;
+    _keys = 0;
+}
+
+void XRA1405_MockTransport::setInputs(uint16_t levels)
+{
+    uint16_t before = gpioState();
+    _inputs = levels;
+    uint16_t after = gpioState();
+
+    // IER with REIR == FEIR fires on both edges, otherwise only on the enabled one (datasheet Table 3)
+    uint16_t inputs = pair(GCR1);
+    uint16_t risingEnable = pair(REIR1);
+    uint16_t fallingEnable = pair(FEIR1);
+    uint16_t bothEdges = ~(risingEnable ^ fallingEnable);
+    uint16_t rising = after & ~before;
+    uint16_t falling = before & ~after;
+    uint16_t fired = inputs & pair(IER1) &
+                     ((rising & (risingEnable | bothEdges)) | (falling & (fallingEnable | bothEdges)));
+
+    _registers[ISR1 >> 1] |= fired & 0xFF;
+    _registers[ISR2 >> 1] |= fired >> 8;
+}
+
+void XRA1405_MockTransport::resetCounters()
+{
+    _bus->transactions = 0;
+    _frames = 0;
+    _bytes = 0;
+    _strayFrames = 0;
+    _busNanos = 0;
+}
+
+uint16_t XRA1405_MockTransport::pair(uint8_t registerCommand) const
+{
+    uint8_t address = registerCommand >> 1;
+    return (uint16_t)(_registers[address + 1] << 8) | _registers[address];
+}
+
+uint8_t XRA1405_MockTransport::readAddress(uint8_t address)
+{
+    if (address == (GSR1 >> 1) || address == (GSR2 >> 1))
+    {
+        // Reading the state clears the interrupt of the same half
+        uint8_t half = address - (GSR1 >> 1);
+        _registers[(ISR1 >> 1) + half] = 0x00;
+        return half == 0 ? (gpioState() & 0xFF) : (gpioState() >> 8);
+    }
+    return _registers[address];
+}
+
+void XRA1405_MockTransport::writeAddress(uint8_t address, uint8_t value)
+{
+    // GSR and ISR are read-only
+    if (address == (GSR1 >> 1) || address == (GSR2 >> 1) || address == (ISR1 >> 1) || address == (ISR2 >> 1))
+    {
+        return;
+    }
+    _registers[address] = value;
+}
+
+uint16_t XRA1405_MockTransport::gpioState() const
+{
+    uint16_t inputs = pair(GCR1);
+    uint16_t levels = _inputs & ~matrixPulledLow();
+    return ((levels ^ pair(PIR1)) & inputs) | (pair(OCR1) & ~inputs);
+}
+
+uint16_t XRA1405_MockTransport::matrixPulledLow() const
+{
+    if (_keys == 0)
+    {
+        return 0;
+    }
+
+    // Spread the low level along closed keys until nothing changes: row to column and back to other rows
+    uint8_t lowRows = (uint8_t)(~pair(GCR1) & ~pair(OCR1) & ~pair(TSCR1));
+    uint8_t lowColumns = 0;
+    for (;;)
+    {
+        uint8_t rows = lowRows;
+        uint8_t columns = lowColumns;
+        for (uint8_t row = 0; row < 8; row++)
+        {
+            uint8_t keys = (uint8_t)(_keys >> (row * 8));
+            if (lowRows & (1 << row))
+            {
+                columns |= keys;
+            }
+            if (keys & lowColumns)
+            {
+                rows |= 1 << row;
+            }
+        }
+        if (rows == lowRows && columns == lowColumns)
+        {
+            return (uint16_t)lowColumns << 8;
+        }
+        lowRows = rows;
+        lowColumns = columns;
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * @file
+ *    XRA1405 Mock Transport
+ *
+ * @brief
+ *    In-memory XRA1405 for host-side tests and benchmarks of the driver logic (cache coherence,
+ *    batching, scanners) without a board. Frames are decoded the way the chip does it: the command
+ *    byte, then data bytes alternating between the two registers of the pair. The 22-register file
+ *    starts at its power-on values and models what the driver relies on: GSR returns the inputs
+ *    through PIR for input pins and OCR for outputs, enabled edges latch ISR bits, and reading a GSR
+ *    register clears the ISR register of the same half. The input filter (IFR) is not modelled.
+ *    setKeyMatrix() wires a key matrix between P0-P7 and P8-P15, and setMaxClock() corrupts reads
+ *    above a clock, for the matrix scanner and the self-test.
+ *
+ *    Every frame is counted along with the SCLK cycles it takes, and busNanos() adds those up at the
+ *    clock of each transaction, so two versions of a driver path can be compared by bus cost alone.
+ *
+ *    Each mock is a bus of its own unless it is built on an XRA1405_MockBus. Mocks on one XRA1405_MockBus
+ *    share the transaction state and busKey(), the way chips on one SPIClass do, so an XRA1405_Group
+ *    over them opens one transaction and none of the chips sees a stray frame.
+ *
+ *    test/ builds the driver for the desktop against a small Arduino shim and runs it on this mock.
+ *
+ * Usage and Examples:
+ *      `XRA1405_MockTransport mock;`
+ *      `XRA1405 expander(mock);`
+ *      `expander.begin(true);`
+ *      `mock.setInputs(0x0100); // Drive P8 high`
+ *      `uint16_t inputs = expander.readPort();`
+ *      `Serial.println(mock.frames());`
+ *      `XRA1405_MockBus bus;`
+ *      `XRA1405_MockTransport first(bus), second(bus); // Two chips for one XRA1405_Group`
+ */
+
+#ifndef XRA1405_MOCK_HPP
+#define XRA1405_MOCK_HPP
+
+#include "XRA1405.hpp"
+
+// Transaction state shared by the mock chips on one bus
+struct XRA1405_MockBus
+{
+    XRA1405_MockBus() : clock(XRA1405_SPI_CLOCK), transactionDepth(0), transactions(0) {}
+
+    uint32_t clock; // Clock of the open (or last) transaction
+    uint8_t transactionDepth;
+    uint32_t transactions;
+};
+
+class XRA1405_MockTransport : public XRA1405_Transport
+{
+public:
+    // A chip on a bus of its own
+    XRA1405_MockTransport();
+
+    // A chip on a shared bus; the bus must outlive the mock
+    explicit XRA1405_MockTransport(XRA1405_MockBus &bus);
+
+    // A copy would keep pointing at the original's bus
+    XRA1405_MockTransport(const XRA1405_MockTransport &) = delete;
+    XRA1405_MockTransport &operator=(const XRA1405_MockTransport &) = delete;
+
+    void begin();
+    void beginTransaction(uint32_t clock);
+    void endTransaction();
+    void transfer(uint8_t *data, uint8_t length);
+    const void *busKey() const { return _bus; }
+
+    // Put every register back to its power-on value, release the inputs (all low) and open every key
+    void reset();
+
+    // Set the level on all 16 pins; pins configured as inputs latch ISR bits on enabled edges
+    void setInputs(uint16_t levels);
+    uint16_t inputs() const { return _inputs; }
+
+    // Close keys of a matrix with rows on P0-P7 and columns on P8-P15, bit row * 8 + column. A column
+    // reads low while a chain of closed keys connects it to a row pin driving low (output, OCR 0, TSCR 0),
+    // so three keys of a rectangle show the fourth as a ghost; otherwise it reads what setInputs() drives.
+    void setKeyMatrix(uint64_t keys) { _keys = keys; }
+
+    // Reads in transactions faster than this return bit 0 flipped, like a marginal MISO line
+    void setMaxClock(uint32_t clock) { _maxClock = clock; }
+
+    // IRQ# is asserted (low) while any ISR bit is set
+    bool interruptAsserted() const { return pair(ISR1) != 0; }
+
+    // Register file access that bypasses the bus and the counters. Writes reach GSR and ISR too.
+    uint8_t registerValue(uint8_t registerCommand) const { return _registers[registerCommand >> 1]; }
+    void setRegisterValue(uint8_t registerCommand, uint8_t value) { _registers[registerCommand >> 1] = value; }
+
+    // Bus cost counters. Transactions are counted for the whole bus, everything else per chip.
+    uint32_t transactions() const { return _bus->transactions; }
+    uint32_t frames() const { return _frames; }
+    uint32_t bytes() const { return _bytes; }
+    uint64_t clockCycles() const { return (uint64_t)_bytes * 8; } // SCLK periods, 8 per byte
+    uint64_t busNanos() const { return _busNanos; }                // SCLK time at each transaction's clock
+
+    // Frames sent without an open transaction; anything but 0 is a driver bug
+    uint32_t strayFrames() const { return _strayFrames; }
+
+    // Clear the counters of this chip and the transaction count of its bus
+    void resetCounters();
+
+private:
+    // Register pair as a 16-bit value, registerCommand being the P0-P7 register
+    uint16_t pair(uint8_t registerCommand) const;
+
+    uint8_t readAddress(uint8_t address);
+    void writeAddress(uint8_t address, uint8_t value);
+
+    // What GSR1/GSR2 would return right now
+    uint16_t gpioState() const;
+
+    // Column pins (P8-P15) the key matrix pulls low
+    uint16_t matrixPulledLow() const;
+
+    XRA1405_MockBus _ownBus;
+    XRA1405_MockBus *_bus; // _ownBus unless the mock was built on a shared bus
+
+    uint8_t _registers[XRA1405_REGISTER_COUNT];
+    uint16_t _inputs;
+    uint64_t _keys;
+    uint32_t _maxClock;
+
+    uint32_t _frames;
+    uint32_t _bytes;
+    uint32_t _strayFrames;
+    uint64_t _busNanos;
+};
+
+#endif // XRA1405_MOCK_HPP
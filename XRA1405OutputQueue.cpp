@@ -0,0 +1,143 @@
+#include "XRA1405OutputQueue.hpp"
+
+#if XRA1405_HAS_ATOMIC
+
+XRA1405_OutputQueue::XRA1405_OutputQueue(XRA1405 *const *devices, uint8_t count)
+    : _devices(devices),
+      _count(count < XRA1405_OUTPUT_QUEUE_MAX_CHIPS ? count : XRA1405_OUTPUT_QUEUE_MAX_CHIPS),
+#if defined(ARDUINO_ARCH_ESP32)
+      _task(nullptr),
+      _stopping(false),
+      _running(false),
+#endif
+      _dropped(0)
+{
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+bool XRA1405_OutputQueue::begin(UBaseType_t priority, BaseType_t core, uint32_t stackSize)
+{
+    if (_task != nullptr)
+    {
+        return true;
+    }
+
+    _stopping = false;
+    _running = true;
+    if (xTaskCreatePinnedToCore(serviceTask, "xra1405_out", stackSize, this, priority, &_task, core) != pdPASS)
+    {
+        _task = nullptr;
+        _running = false;
+        return false;
+    }
+    return true;
+}
+
+void XRA1405_OutputQueue::end()
+{
+    if (_task == nullptr)
+    {
+        return;
+    }
+
+    // Deleting the task from here could catch it inside modifyPort() holding the bus lock
+    TaskHandle_t task = _task;
+    _task = nullptr;
+    _stopping = true;
+    xTaskNotifyGive(task);
+    while (_running)
+    {
+        vTaskDelay(1);
+    }
+}
+#endif
+
+bool XRA1405_OutputQueue::post(uint8_t chip, uint16_t andMask, uint16_t xorMask)
+{
+    if (chip >= _count)
+    {
+        return false;
+    }
+
+    Command command = {chip, andMask, xorMask};
+    if (!_ring.push(command))
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Wake the service task; it takes everything queued so far in one pass
+    if (_task != nullptr)
+    {
+        if (xPortInIsrContext())
+        {
+            BaseType_t higherPriorityTaskWoken = pdFALSE;
+            vTaskNotifyGiveFromISR(_task, &higherPriorityTaskWoken);
+            if (higherPriorityTaskWoken == pdTRUE)
+            {
+                portYIELD_FROM_ISR();
+            }
+        }
+        else
+        {
+            xTaskNotifyGive(_task);
+        }
+    }
+#endif
+    return true;
+}
+
+uint8_t XRA1405_OutputQueue::drain()
+{
+    uint16_t andMasks[XRA1405_OUTPUT_QUEUE_MAX_CHIPS];
+    uint16_t xorMasks[XRA1405_OUTPUT_QUEUE_MAX_CHIPS];
+    uint32_t dirtyChips = 0;
+
+    // Fold commands in order: applying f then g gives and = f.and & g.and, xor = (f.xor & g.and) ^ g.xor
+    Command command;
+    while (_ring.pop(command))
+    {
+        uint32_t chipBit = 1UL << command.chip;
+        if (!(dirtyChips & chipBit))
+        {
+            andMasks[command.chip] = 0xFFFF;
+            xorMasks[command.chip] = 0;
+            dirtyChips |= chipBit;
+        }
+        andMasks[command.chip] &= command.andMask;
+        xorMasks[command.chip] = (xorMasks[command.chip] & command.andMask) ^ command.xorMask;
+    }
+
+    uint8_t writes = 0;
+    for (uint8_t chip = 0; chip < _count; chip++)
+    {
+        if (dirtyChips & (1UL << chip))
+        {
+            _devices[chip]->modifyPort(andMasks[chip], xorMasks[chip]);
+            writes++;
+        }
+    }
+    return writes;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void XRA1405_OutputQueue::serviceTask(void *queue)
+{
+    XRA1405_OutputQueue *self = static_cast<XRA1405_OutputQueue *>(queue);
+    while (!self->_stopping)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!self->_stopping)
+        {
+            self->drain();
+        }
+    }
+
+    self->_running = false;
+    vTaskDelete(nullptr);
+}
+#endif
+
+#endif // XRA1405_HAS_ATOMIC
@@ -0,0 +1,102 @@
+/**
+ * @file
+ *    XRA1405 Output Command Queue
+ *
+ * @brief
+ *    Decouples output changes from the bus. Application tasks post "set/clear/toggle mask
+ *    on chip N" commands into a lock-free ring and return immediately; a service task pinned to one core
+ *    drains the ring, folds every command for the same chip into one (and, xor) mask pair and writes
+ *    each affected OCR1/OCR2 pair once. A burst of pin changes collapses into one frame per chip.
+ *
+ *    Enable the shadow cache on the devices so the service task does not read OCR back before writing.
+ *
+ *    The service task is ESP32 only. Wherever XRA1405_HAS_ATOMIC is set (see XRA1405Ring.hpp) the
+ *    queue itself builds too, and the application calls drain() from its own loop.
+ *
+ * Usage and Examples:
+ *      `XRA1405 *devices[] = {&expanderA, &expanderB};`
+ *      `XRA1405_OutputQueue outputs(devices, 2);`
+ *      `outputs.begin(); // Service task on core 1`
+ *      `outputs.setMask(0, 1 << 3); // Chip 0, pin 3 high, returns without touching the bus`
+ *      `outputs.toggleMask(1, 0x00FF);`
+ */
+
+#ifndef XRA1405_OUTPUT_QUEUE_HPP
+#define XRA1405_OUTPUT_QUEUE_HPP
+
+#include "XRA1405.hpp"
+#include "XRA1405Ring.hpp"
+
+#if XRA1405_HAS_ATOMIC
+
+#include <atomic>
+
+// Number of commands the ring holds (power of two)
+#ifndef XRA1405_OUTPUT_QUEUE_CAPACITY
+#define XRA1405_OUTPUT_QUEUE_CAPACITY 64
+#endif
+
+// Number of chips one queue can serve
+#ifndef XRA1405_OUTPUT_QUEUE_MAX_CHIPS
+#define XRA1405_OUTPUT_QUEUE_MAX_CHIPS 16
+#endif
+
+// drain() tracks the chips it has commands for in one 32-bit word
+static_assert(XRA1405_OUTPUT_QUEUE_MAX_CHIPS <= 32, "XRA1405_OUTPUT_QUEUE_MAX_CHIPS must be 32 or less");
+
+class XRA1405_OutputQueue
+{
+public:
+    // The device array must outlive the queue
+    XRA1405_OutputQueue(XRA1405 *const *devices, uint8_t count);
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Start the service task. Returns false if the task could not be created.
+    bool begin(UBaseType_t priority = 5, BaseType_t core = 1, uint32_t stackSize = 2048);
+
+    // Stop the service task and wait for it to exit. The task finishes the drain it is in, so it never
+    // dies holding the bus. Commands posted after that stay in the ring until drain(). Do not post
+    // concurrently with end().
+    void end();
+#endif
+
+    // Post commands for chip index `chip`. Safe from any task or ISR, never touches the bus.
+    // Returns false if the ring is full (the command is dropped and counted).
+    bool setMask(uint8_t chip, uint16_t mask) { return post(chip, ~mask, mask); }
+    bool clearMask(uint8_t chip, uint16_t mask) { return post(chip, ~mask, 0); }
+    bool toggleMask(uint8_t chip, uint16_t mask) { return post(chip, 0xFFFF, mask); }
+    bool writeMasked(uint8_t chip, uint16_t mask, uint16_t value) { return post(chip, ~mask, value & mask); }
+
+    // Drain and coalesce the ring from the calling task. Returns the number of OCR pair writes issued.
+    // The service task runs this; call it directly only when begin() was not used.
+    uint8_t drain();
+
+    // Commands dropped because the ring was full
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Command
+    {
+        uint8_t chip;
+        uint16_t andMask;
+        uint16_t xorMask;
+    };
+
+    bool post(uint8_t chip, uint16_t andMask, uint16_t xorMask);
+
+    XRA1405 *const *_devices;
+    uint8_t _count;
+    XRA1405_Ring<Command, XRA1405_OUTPUT_QUEUE_CAPACITY> _ring;
+#if defined(ARDUINO_ARCH_ESP32)
+    static void serviceTask(void *queue);
+
+    TaskHandle_t _task;
+    std::atomic<bool> _stopping; // Set by end(), the service task leaves its loop
+    std::atomic<bool> _running;  // Cleared by the service task just before it deletes itself
+#endif
+    std::atomic<uint32_t> _dropped;
+};
+
+#endif // XRA1405_HAS_ATOMIC
+
+#endif // XRA1405_OUTPUT_QUEUE_HPP
@@ -0,0 +1,250 @@
+#include "XRA1405Pwm.hpp"
+
+XRA1405_Pwm::XRA1405_Pwm(XRA1405_Group &group, uint32_t baseMicros)
+    : _group(group),
+      _count(group.size() < XRA1405_PWM_MAX_CHIPS ? group.size() : XRA1405_PWM_MAX_CHIPS),
+      _baseMicros(baseMicros),
+      _pendingPlanes(),
+      _pendingMask(),
+      _activePlanes(),
+      _activeMask(),
+      _lastWritten(),
+      _pendingChanged(false),
+      _lastWrittenValid(false),
+      _running(false),
+      _plane(0),
+      _deadline(0),
+      _writes(0)
+#if defined(ARDUINO_ARCH_ESP32)
+      ,
+      _planeLock(portMUX_INITIALIZER_UNLOCKED),
+      _timer(nullptr),
+      _timerDriven(false),
+      _inCallback(false)
+#endif
+{
+}
+
+XRA1405_Pwm::~XRA1405_Pwm()
+{
+    stop();
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_timer != nullptr)
+    {
+        esp_timer_delete(_timer); // stop() left it disarmed with no callback running
+    }
+#endif
+}
+
+void XRA1405_Pwm::setDuty(uint8_t chip, uint8_t pin, uint8_t duty)
+{
+    if (chip >= _count || pin >= 16)
+    {
+        return;
+    }
+
+    uint16_t pinBit = 1 << pin;
+#if defined(ARDUINO_ARCH_ESP32)
+    portENTER_CRITICAL(&_planeLock);
+#endif
+    // Only this pin's bit changes in each plane, nothing else is recomputed
+    for (uint8_t plane = 0; plane < XRA1405_PWM_BITS; plane++)
+    {
+        if (duty & (1 << plane))
+        {
+            _pendingPlanes[chip][plane] |= pinBit;
+        }
+        else
+        {
+            _pendingPlanes[chip][plane] &= ~pinBit;
+        }
+    }
+    _pendingMask[chip] |= pinBit;
+    _pendingChanged = true;
+#if defined(ARDUINO_ARCH_ESP32)
+    portEXIT_CRITICAL(&_planeLock);
+#endif
+}
+
+void XRA1405_Pwm::release(uint8_t chip, uint8_t pin)
+{
+    if (chip >= _count || pin >= 16)
+    {
+        return;
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    portENTER_CRITICAL(&_planeLock);
+#endif
+    _pendingMask[chip] &= ~(1 << pin);
+    _pendingChanged = true;
+#if defined(ARDUINO_ARCH_ESP32)
+    portEXIT_CRITICAL(&_planeLock);
+#endif
+}
+
+uint8_t XRA1405_Pwm::duty(uint8_t chip, uint8_t pin) const
+{
+    if (chip >= _count || pin >= 16)
+    {
+        return 0;
+    }
+
+    uint8_t value = 0;
+    for (uint8_t plane = 0; plane < XRA1405_PWM_BITS; plane++)
+    {
+        if (_pendingPlanes[chip][plane] & (1 << pin))
+        {
+            value |= 1 << plane;
+        }
+    }
+    return value;
+}
+
+void XRA1405_Pwm::start()
+{
+    stop();
+    reset();
+    writePlane();
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool XRA1405_Pwm::startTimer()
+{
+    stop();
+
+    if (_timer == nullptr)
+    {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = timerCallback;
+        timerArgs.arg = this;
+        timerArgs.dispatch_method = ESP_TIMER_TASK;
+        timerArgs.name = "xra1405_pwm";
+        if (esp_timer_create(&timerArgs, &_timer) != ESP_OK)
+        {
+            _timer = nullptr;
+            return false;
+        }
+    }
+
+    _timerDriven = true;
+    reset();
+    timerCallback(this); // First plane goes out now, the callback arms the timer for the next one
+    return true;
+}
+
+void XRA1405_Pwm::timerCallback(void *pwm)
+{
+    XRA1405_Pwm *self = static_cast<XRA1405_Pwm *>(pwm);
+    self->_inCallback = true;
+    if (self->_running)
+    {
+        self->writePlane();
+    }
+
+    // Re-arm against the absolute deadline so plane lengths stay exact on average
+    if (self->_running)
+    {
+        int32_t wait = (int32_t)(self->_deadline - self->now());
+        esp_timer_start_once(self->_timer, wait > 0 ? (uint64_t)wait : 0);
+    }
+    self->_inCallback = false;
+}
+#endif
+
+void XRA1405_Pwm::stop()
+{
+    _running = false;
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_timer != nullptr)
+    {
+        // A callback already past its _running check may still re-arm: let it finish, then disarm
+        while (_inCallback)
+        {
+            vTaskDelay(1);
+        }
+        esp_timer_stop(_timer); // Fails harmlessly when the timer is not armed
+    }
+    _timerDriven = false;
+#endif
+}
+
+bool XRA1405_Pwm::poll()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_timerDriven)
+    {
+        return false;
+    }
+#endif
+    if (!_running || (int32_t)(now() - _deadline) < 0)
+    {
+        return false;
+    }
+
+    return writePlane();
+}
+
+void XRA1405_Pwm::reset()
+{
+    _plane = 0;
+    _pendingChanged = true; // Load the pending planes at the first period
+    _lastWrittenValid = false;
+    _deadline = now();
+    _running = true;
+}
+
+uint32_t XRA1405_Pwm::now() const
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    return (uint32_t)esp_timer_get_time();
+#else
+    return micros();
+#endif
+}
+
+bool XRA1405_Pwm::writePlane()
+{
+    // Duty changes are picked up between periods only
+    if (_plane == 0 && _pendingChanged)
+    {
+#if defined(ARDUINO_ARCH_ESP32)
+        portENTER_CRITICAL(&_planeLock);
+#endif
+        memcpy(_activePlanes, _pendingPlanes, sizeof(_activePlanes));
+        memcpy(_activeMask, _pendingMask, sizeof(_activeMask));
+        _pendingChanged = false;
+#if defined(ARDUINO_ARCH_ESP32)
+        portEXIT_CRITICAL(&_planeLock);
+#endif
+        _lastWrittenValid = false;
+    }
+
+    uint16_t andMasks[XRA1405_PWM_MAX_CHIPS];
+    uint16_t xorMasks[XRA1405_PWM_MAX_CHIPS];
+    bool changed = !_lastWrittenValid;
+    for (uint8_t chip = 0; chip < _count; chip++)
+    {
+        andMasks[chip] = ~_activeMask[chip];
+        xorMasks[chip] = _activePlanes[chip][_plane] & _activeMask[chip];
+        if (xorMasks[chip] != _lastWritten[chip])
+        {
+            changed = true;
+        }
+    }
+
+    // Plane n is held for 2^n base periods
+    _deadline += _baseMicros << _plane;
+    _plane = (_plane + 1) % XRA1405_PWM_BITS;
+
+    if (!changed)
+    {
+        return false;
+    }
+
+    _group.modifyOutputs(andMasks, xorMasks, _count);
+    memcpy(_lastWritten, xorMasks, _count * sizeof(uint16_t));
+    _lastWrittenValid = true;
+    _writes++;
+    return true;
+}
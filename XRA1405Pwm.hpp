@@ -0,0 +1,116 @@
+/**
+ * @file
+ *    XRA1405 Software PWM
+ *
+ * @brief
+ *    Dimmable outputs on every pin of a group using binary code modulation (BAM). Each duty value is
+ *    split into bit planes; plane n is shown for 2^n base periods, so one PWM period takes
+ *    XRA1405_PWM_BITS writes per chip no matter how many channels are active, and all chips of a
+ *    plane go out in one transaction. A plane identical to the previous one is not written at all.
+ *
+ *    setDuty() only flips the pin's bit in each plane of a pending copy; the planes in use are swapped
+ *    at the start of the next period, so a duty change never tears a period. Pins that are not under
+ *    PWM keep their values (taken from the shadow cache, so enable it on the devices). The PWM pins
+ *    must already be outputs.
+ *
+ *    On ESP32, startTimer() runs the planes from an esp_timer one-shot (keep baseMicros at about
+ *    50 us or more for the esp_timer task). start() and poll() do the same from loop() anywhere.
+ *    PWM frequency = 1 / (baseMicros * (2^XRA1405_PWM_BITS - 1)).
+ *
+ * Usage and Examples:
+ *      `XRA1405_Pwm pwm(group, 50); // 50 us LSB, 8 bits: about 78 Hz`
+ *      `pwm.setDuty(0, 3, 128);     // Chip 0, pin 3 at 50%`
+ *      `pwm.setDuty(1, 15, 16);`
+ *      `pwm.startTimer();`
+ */
+
+#ifndef XRA1405_PWM_HPP
+#define XRA1405_PWM_HPP
+
+#include "XRA1405Group.hpp"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#endif
+
+// Duty resolution in bits (1-8); duty values run from 0 (off) to 2^bits - 1 (always on)
+#ifndef XRA1405_PWM_BITS
+#define XRA1405_PWM_BITS 8
+#endif
+
+#if XRA1405_PWM_BITS < 1 || XRA1405_PWM_BITS > 8
+#error "XRA1405_PWM_BITS must be 1-8"
+#endif
+
+// Number of chips one PWM engine can drive
+#ifndef XRA1405_PWM_MAX_CHIPS
+#define XRA1405_PWM_MAX_CHIPS 16
+#endif
+
+class XRA1405_Pwm
+{
+public:
+    // The group must outlive the engine. Only its first XRA1405_PWM_MAX_CHIPS chips are driven.
+    XRA1405_Pwm(XRA1405_Group &group, uint32_t baseMicros = 50);
+    ~XRA1405_Pwm();
+
+    // Put a pin under PWM with the given duty (takes effect at the next period)
+    void setDuty(uint8_t chip, uint8_t pin, uint8_t duty);
+
+    // Take a pin out of PWM; it keeps whatever level it had last
+    void release(uint8_t chip, uint8_t pin);
+
+    uint8_t duty(uint8_t chip, uint8_t pin) const;
+
+    // Start from the first plane and advance from poll()
+    void start();
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Start and advance from an esp_timer callback. Returns false if the timer could not be created.
+    bool startTimer();
+#endif
+
+    void stop();
+
+    // Write the next plane once it is due. Returns true if the bus was used.
+    bool poll();
+
+    bool running() const { return _running; }
+
+    // Group writes issued, for checking the bus load
+    uint32_t writes() const { return _writes; }
+
+private:
+    void reset();
+    uint32_t now() const;
+    bool writePlane();
+
+    XRA1405_Group &_group;
+    uint8_t _count;
+    uint32_t _baseMicros;
+
+    // Bit plane n of chip i: pins whose duty has bit n set. Pending is edited by setDuty, active is shown.
+    uint16_t _pendingPlanes[XRA1405_PWM_MAX_CHIPS][XRA1405_PWM_BITS];
+    uint16_t _pendingMask[XRA1405_PWM_MAX_CHIPS];
+    uint16_t _activePlanes[XRA1405_PWM_MAX_CHIPS][XRA1405_PWM_BITS];
+    uint16_t _activeMask[XRA1405_PWM_MAX_CHIPS];
+    uint16_t _lastWritten[XRA1405_PWM_MAX_CHIPS];
+    volatile bool _pendingChanged;
+    bool _lastWrittenValid;
+
+    volatile bool _running;
+    uint8_t _plane;
+    uint32_t _deadline;
+    uint32_t _writes;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    static void timerCallback(void *pwm);
+
+    portMUX_TYPE _planeLock;
+    esp_timer_handle_t _timer;
+    bool _timerDriven;
+    volatile bool _inCallback; // The esp_timer task is inside timerCallback(), stop() waits it out
+#endif
+};
+
+#endif // XRA1405_PWM_HPP
@@ -0,0 +1,121 @@
+/**
+ * @file
+ *    XRA1405 Ring Buffer
+ *
+ * @brief
+ *    Fixed-size lock-free ring for handing small records from many producers (tasks or ISRs) to one
+ *    consumer task. Storage is preallocated in the object; push and pop never allocate or block.
+ *    Each cell carries a sequence number so producers claim slots with a single compare-and-swap
+ *    and the consumer never sees a half-written record.
+ *
+ *    Needs <atomic> with lock-free 32-bit compare-and-swap. That is on by default for the ESP32 and for
+ *    host builds (no ARDUINO defined); AVR has no <atomic> and Cortex-M0 has no CAS, so everywhere else
+ *    XRA1405_Ring and XRA1405_EventLog compile to nothing unless the core is known to have both
+ *    (e.g. Cortex-M3 and up) and the build passes -DXRA1405_HAS_ATOMIC=1.
+ */
+
+#ifndef XRA1405_RING_HPP
+#define XRA1405_RING_HPP
+
+// Set by the build (-D) only: the library .cpp files never see a #define placed in a sketch
+#ifndef XRA1405_HAS_ATOMIC
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+#define XRA1405_HAS_ATOMIC 1
+#else
+#define XRA1405_HAS_ATOMIC 0
+#endif
+#endif
+
+#if XRA1405_HAS_ATOMIC
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint16_t Capacity>
+class XRA1405_Ring
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    XRA1405_Ring()
+        : _head(0),
+          _tail(0)
+    {
+        for (uint32_t i = 0; i < Capacity; i++)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Add a record from any producer. Returns false (and drops the record) when the ring is full.
+    bool push(const T &item)
+    {
+        uint32_t position = _head.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;)
+        {
+            cell = &_cells[position & (Capacity - 1)];
+            uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+            int32_t difference = (int32_t)(sequence - position);
+            if (difference == 0)
+            {
+                // Slot is free for this position, claim it
+                if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The consumer has not freed this slot yet
+            }
+            else
+            {
+                position = _head.load(std::memory_order_relaxed); // Another producer took it, retry
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release); // Publish to the consumer
+        return true;
+    }
+
+    // Take the oldest record. Single consumer only. Returns false when the ring is empty.
+    bool pop(T &item)
+    {
+        Cell &cell = _cells[_tail & (Capacity - 1)];
+        uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if ((int32_t)(sequence - (_tail + 1)) < 0)
+        {
+            return false;
+        }
+
+        item = cell.item;
+        cell.sequence.store(_tail + Capacity, std::memory_order_release); // Free the slot for the next lap
+        _tail++;
+        return true;
+    }
+
+    bool empty() const
+    {
+        const Cell &cell = _cells[_tail & (Capacity - 1)];
+        return (int32_t)(cell.sequence.load(std::memory_order_acquire) - (_tail + 1)) < 0;
+    }
+
+    static constexpr uint16_t capacity() { return Capacity; }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint32_t> sequence;
+        T item;
+    };
+
+    Cell _cells[Capacity];
+    std::atomic<uint32_t> _head; // Next position producers claim
+    uint32_t _tail;              // Next position the consumer reads
+};
+
+#endif // XRA1405_HAS_ATOMIC
+
+#endif // XRA1405_RING_HPP
@@ -0,0 +1,107 @@
+#include "XRA1405Scanner.hpp"
+
+XRA1405_Scanner::XRA1405_Scanner(XRA1405_Group &group, uint16_t periodMillis)
+    : _group(group),
+      _count(group.size() < XRA1405_SCANNER_MAX_CHIPS ? group.size() : XRA1405_SCANNER_MAX_CHIPS),
+      _periodMillis(periodMillis),
+      _lastScan(0),
+      _callback(nullptr),
+      _context(nullptr)
+{
+    for (uint8_t chip = 0; chip < XRA1405_SCANNER_MAX_CHIPS; chip++)
+    {
+        _stable[chip] = 0;
+        _counterLow[chip] = 0;
+        _counterHigh[chip] = 0;
+        _debounceMask[chip] = 0xFFFF;
+        _changes[chip] = 0;
+    }
+}
+
+void XRA1405_Scanner::begin(XRA1405_ScanCallback callback, void *context)
+{
+    _callback = callback;
+    _context = context;
+
+    uint16_t samples[XRA1405_SCANNER_MAX_CHIPS];
+    _group.readInputs(samples, _count);
+    for (uint8_t chip = 0; chip < _count; chip++)
+    {
+        _stable[chip] = samples[chip];
+        _counterLow[chip] = 0;
+        _counterHigh[chip] = 0;
+        _changes[chip] = 0;
+    }
+    _lastScan = millis();
+}
+
+bool XRA1405_Scanner::poll()
+{
+    uint32_t now = millis();
+    if (now - _lastScan < _periodMillis)
+    {
+        return false;
+    }
+    _lastScan = now;
+    return scan();
+}
+
+bool XRA1405_Scanner::scan()
+{
+    // One paired GSR read per chip, all in one transaction
+    uint16_t samples[XRA1405_SCANNER_MAX_CHIPS];
+    _group.readInputs(samples, _count);
+
+    bool anyChange = false;
+    for (uint8_t chip = 0; chip < _count; chip++)
+    {
+        // Count consecutive scans that disagree with the stable state, reset as soon as a pin agrees again
+        uint16_t delta = samples[chip] ^ _stable[chip];
+        _counterHigh[chip] = (_counterHigh[chip] ^ _counterLow[chip]) & delta;
+        _counterLow[chip] = ~_counterLow[chip] & delta;
+
+        // Counter at 3 means the new level held for XRA1405_SCAN_STABLE_SAMPLES scans
+        uint16_t toggled = (_counterHigh[chip] & _counterLow[chip]) | (delta & ~_debounceMask[chip]);
+        if (toggled == 0)
+        {
+            continue;
+        }
+
+        _stable[chip] ^= toggled;
+        _counterLow[chip] &= ~toggled;
+        _counterHigh[chip] &= ~toggled;
+        _changes[chip] |= toggled;
+        anyChange = true;
+
+        if (_callback != nullptr)
+        {
+            _callback(chip, toggled, _stable[chip], _context);
+        }
+    }
+    return anyChange;
+}
+
+void XRA1405_Scanner::setDebounceMask(uint8_t chip, uint16_t mask)
+{
+    if (chip < _count)
+    {
+        _debounceMask[chip] = mask;
+    }
+}
+
+uint16_t XRA1405_Scanner::state(uint8_t chip) const
+{
+    return chip < _count ? _stable[chip] : 0;
+}
+
+uint16_t XRA1405_Scanner::takeChanges(uint8_t chip)
+{
+    if (chip >= _count)
+    {
+        return 0;
+    }
+
+    uint16_t changes = _changes[chip];
+    _changes[chip] = 0;
+    return changes;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file
+ *    XRA1405 Input Scanner
+ *
+ * @brief
+ *    Periodic input scan with software debounce for every chip of a group. Each scan is one GSR1/GSR2
+ *    paired read per chip inside a single bus transaction. Debounce state is kept as a two-bit vertical
+ *    counter per chip (two 16-bit bit planes), so all 16 pins are filtered with a handful of word
+ *    operations and no per-pin branching. A pin only reports a change after it has read the new level
+ *    on XRA1405_SCAN_STABLE_SAMPLES consecutive scans.
+ *
+ *    The chip's input filter (IFR) only gates interrupt generation; GSR reads always return the raw pin
+ *    level (datasheet 2.21), so the software debounce applies whether IFR is enabled or not. Pins driven
+ *    by clean digital sources can skip it with setDebounceMask().
+ *
+ * Usage and Examples:
+ *      `XRA1405_Group group(devices, 2);`
+ *      `XRA1405_Scanner scanner(group, 5); // Scan every 5 ms`
+ *      `group.begin();`
+ *      `scanner.begin(onInputsChanged, nullptr);`
+ *      `void loop() { scanner.poll(); }`
+ */
+
+#ifndef XRA1405_SCANNER_HPP
+#define XRA1405_SCANNER_HPP
+
+#include "XRA1405Group.hpp"
+
+// Number of chips one scanner can track
+#ifndef XRA1405_SCANNER_MAX_CHIPS
+#define XRA1405_SCANNER_MAX_CHIPS 16
+#endif
+
+// Consecutive identical scans before a change is reported (fixed by the two-bit vertical counter)
+#define XRA1405_SCAN_STABLE_SAMPLES 3
+
+// Stable change callback, changedMask holds the pins that changed on chip index `chip`
+typedef void (*XRA1405_ScanCallback)(uint8_t chip, uint16_t changedMask, uint16_t state, void *context);
+
+class XRA1405_Scanner
+{
+public:
+    // The group must outlive the scanner. Only its first XRA1405_SCANNER_MAX_CHIPS chips are scanned.
+    XRA1405_Scanner(XRA1405_Group &group, uint16_t periodMillis = 5);
+
+    // Take the current inputs as the initial stable state. No events are raised for it.
+    void begin(XRA1405_ScanCallback callback = nullptr, void *context = nullptr);
+
+    // Scan if the period has elapsed since the last scan. Returns true if any stable change was found.
+    bool poll();
+
+    // Scan now, regardless of the period
+    bool scan();
+
+    void setPeriod(uint16_t periodMillis) { _periodMillis = periodMillis; }
+
+    // Pins in mask are debounced (default all), the others report on the first scan that sees them change
+    void setDebounceMask(uint8_t chip, uint16_t mask);
+
+    // Debounced input state of chip index `chip` (0 past the scanned chips)
+    uint16_t state(uint8_t chip) const;
+
+    // Pins that changed since the last call, for consumers that poll instead of using the callback
+    uint16_t takeChanges(uint8_t chip);
+
+private:
+    XRA1405_Group &_group;
+    uint8_t _count;
+    uint16_t _periodMillis;
+    uint32_t _lastScan;
+    XRA1405_ScanCallback _callback;
+    void *_context;
+
+    // Per chip: debounced state, vertical counter bit planes, debounce enable and unread changes
+    uint16_t _stable[XRA1405_SCANNER_MAX_CHIPS];
+    uint16_t _counterLow[XRA1405_SCANNER_MAX_CHIPS];
+    uint16_t _counterHigh[XRA1405_SCANNER_MAX_CHIPS];
+    uint16_t _debounceMask[XRA1405_SCANNER_MAX_CHIPS];
+    uint16_t _changes[XRA1405_SCANNER_MAX_CHIPS];
+};
+
+#endif // XRA1405_SCANNER_HPP
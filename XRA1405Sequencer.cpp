@@ -0,0 +1,189 @@
+#include "XRA1405Sequencer.hpp"
+
+XRA1405_Sequencer::XRA1405_Sequencer(XRA1405_Group &group)
+    : _group(group),
+      _patterns(nullptr),
+      _holdMicros(nullptr),
+      _periodMicros(0),
+      _steps(0),
+      _repeat(false),
+      _running(false),
+      _step(0),
+      _deadline(0),
+      _lateSteps(0)
+#if defined(ARDUINO_ARCH_ESP32)
+      ,
+      _timer(nullptr),
+      _timerDriven(false),
+      _inCallback(false)
+#endif
+{
+}
+
+XRA1405_Sequencer::~XRA1405_Sequencer()
+{
+    stop();
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_timer != nullptr)
+    {
+        esp_timer_delete(_timer); // stop() left it disarmed with no callback running
+    }
+#endif
+}
+
+void XRA1405_Sequencer::load(const uint16_t *patterns, uint16_t steps, uint32_t periodMicros, bool repeat)
+{
+    stop();
+    _patterns = patterns;
+    _holdMicros = nullptr;
+    _periodMicros = periodMicros;
+    _steps = steps;
+    _repeat = repeat;
+}
+
+void XRA1405_Sequencer::load(const uint16_t *patterns, uint16_t steps, const uint32_t *holdMicros, bool repeat)
+{
+    stop();
+    _patterns = patterns;
+    _holdMicros = holdMicros;
+    _periodMicros = 0;
+    _steps = steps;
+    _repeat = repeat;
+}
+
+bool XRA1405_Sequencer::start()
+{
+    stop();
+    if (_patterns == nullptr || _steps == 0)
+    {
+        return false;
+    }
+
+    reset();
+    writeStep();
+    return true;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool XRA1405_Sequencer::startTimer()
+{
+    stop();
+    if (_patterns == nullptr || _steps == 0)
+    {
+        return false;
+    }
+
+    if (_timer == nullptr)
+    {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = timerCallback;
+        timerArgs.arg = this;
+        timerArgs.dispatch_method = ESP_TIMER_TASK;
+        timerArgs.name = "xra1405_seq";
+        if (esp_timer_create(&timerArgs, &_timer) != ESP_OK)
+        {
+            _timer = nullptr;
+            return false;
+        }
+    }
+
+    _timerDriven = true;
+    reset();
+    timerCallback(this); // Step 0 goes out now, the callback arms the timer for step 1
+    return true;
+}
+
+void XRA1405_Sequencer::timerCallback(void *sequencer)
+{
+    XRA1405_Sequencer *self = static_cast<XRA1405_Sequencer *>(sequencer);
+    self->_inCallback = true;
+    if (self->_running)
+    {
+        self->writeStep();
+    }
+
+    // Re-arm against the absolute deadline so the callback latency does not add up from step to step
+    if (self->_running)
+    {
+        int32_t wait = (int32_t)(self->_deadline - self->now());
+        esp_timer_start_once(self->_timer, wait > 0 ? (uint64_t)wait : 0);
+    }
+    self->_inCallback = false;
+}
+#endif
+
+void XRA1405_Sequencer::stop()
+{
+    _running = false;
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_timer != nullptr)
+    {
+        // A callback already past its _running check may still re-arm: let it finish, then disarm
+        while (_inCallback)
+        {
+            vTaskDelay(1);
+        }
+        esp_timer_stop(_timer); // Fails harmlessly when the timer is not armed
+    }
+    _timerDriven = false;
+#endif
+}
+
+bool XRA1405_Sequencer::poll()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_timerDriven)
+    {
+        return false;
+    }
+#endif
+    if (!_running || (int32_t)(now() - _deadline) < 0)
+    {
+        return false;
+    }
+
+    writeStep();
+    return true;
+}
+
+void XRA1405_Sequencer::reset()
+{
+    _step = 0;
+    _lateSteps = 0;
+    _deadline = now();
+    _running = true;
+}
+
+uint32_t XRA1405_Sequencer::now() const
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    return (uint32_t)esp_timer_get_time();
+#else
+    return micros();
+#endif
+}
+
+void XRA1405_Sequencer::writeStep()
+{
+    uint16_t step = _step;
+    _group.writeOutputs(&_patterns[(uint32_t)step * _group.size()]);
+
+    // The next deadline is relative to this step's deadline, not to when it actually went out
+    _deadline += _holdMicros != nullptr ? _holdMicros[step] : _periodMicros;
+    if ((int32_t)(now() - _deadline) >= 0)
+    {
+        _lateSteps++;
+    }
+
+    step++;
+    if (step >= _steps)
+    {
+        if (!_repeat)
+        {
+            _running = false;
+            return;
+        }
+        step = 0;
+    }
+    _step = step;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file
+ *    XRA1405 Output Pattern Sequencer
+ *
+ * @brief
+ *    Streams a precomputed table of 16-bit output values to every chip of a group with per-step hold
+ *    times, e.g. step/direction pulse trains or multiplexed LED scans. Each step is one OCR1/OCR2 frame
+ *    per chip inside a single bus transaction, so all outputs of a step change together.
+ *
+ *    On ESP32, startTimer() drives the steps from an esp_timer one-shot that is re-armed against an
+ *    absolute deadline, so timer latency never accumulates into drift. Anywhere else (or when the
+ *    sequence should follow loop()), start() and poll() do the same from micros().
+ *
+ *    The pattern and hold tables are read in place and must stay valid while the sequencer runs.
+ *
+ * Usage and Examples:
+ *      `// Two chips, patterns[step * 2 + chip]`
+ *      `static const uint16_t patterns[] = {0x0001, 0x0100, 0x0002, 0x0200, 0x0004, 0x0400};`
+ *      `XRA1405_Sequencer sequencer(group);`
+ *      `sequencer.load(patterns, 3, 500); // 3 steps, 500 us each, repeating`
+ *      `sequencer.startTimer();          // ESP32; or sequencer.start() and sequencer.poll() in loop()`
+ */
+
+#ifndef XRA1405_SEQUENCER_HPP
+#define XRA1405_SEQUENCER_HPP
+
+#include "XRA1405Group.hpp"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#endif
+
+class XRA1405_Sequencer
+{
+public:
+    // The group must outlive the sequencer
+    explicit XRA1405_Sequencer(XRA1405_Group &group);
+    ~XRA1405_Sequencer();
+
+    // Load a table of `steps` rows of group.size() values (patterns[step * group.size() + chip]).
+    // Every step is held for periodMicros, or for holdMicros[step] with the second form.
+    // Loading stops a running sequence.
+    void load(const uint16_t *patterns, uint16_t steps, uint32_t periodMicros, bool repeat = true);
+    void load(const uint16_t *patterns, uint16_t steps, const uint32_t *holdMicros, bool repeat = true);
+
+    // Write step 0 now and advance from poll()
+    bool start();
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Write step 0 now and advance from an esp_timer callback. Returns false if the timer could not be created.
+    bool startTimer();
+#endif
+
+    // Stop after the step currently on the outputs (the outputs keep that value)
+    void stop();
+
+    // Write the next step once its deadline has passed. Call often from loop() after start().
+    // Returns true if a step was written.
+    bool poll();
+
+    bool running() const { return _running; }
+    uint16_t step() const { return _step; }
+
+    // Steps that went out after the following step was already due (the hold time was too short to keep up)
+    uint32_t lateSteps() const { return _lateSteps; }
+
+private:
+    void reset();
+    uint32_t now() const;
+    void writeStep();
+
+    XRA1405_Group &_group;
+    const uint16_t *_patterns;
+    const uint32_t *_holdMicros;
+    uint32_t _periodMicros;
+    uint16_t _steps;
+    bool _repeat;
+
+    volatile bool _running;
+    volatile uint16_t _step;
+    uint32_t _deadline;
+    volatile uint32_t _lateSteps;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    static void timerCallback(void *sequencer);
+
+    esp_timer_handle_t _timer;
+    bool _timerDriven;
+    volatile bool _inCallback; // The esp_timer task is inside timerCallback(), stop() waits it out
+#endif
+};
+
+#endif // XRA1405_SEQUENCER_HPP
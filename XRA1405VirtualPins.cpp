@@ -0,0 +1,146 @@
+#include "XRA1405VirtualPins.hpp"
+
+XRA1405_VirtualPins::XRA1405_VirtualPins(XRA1405_Group &group)
+    : _group(group),
+      _map(nullptr),
+      _count((uint16_t)(group.size() < XRA1405_VPIN_MAX_CHIPS ? group.size() : XRA1405_VPIN_MAX_CHIPS) * 16)
+{
+}
+
+XRA1405_VirtualPins::XRA1405_VirtualPins(XRA1405_Group &group, const uint8_t *map, uint16_t count)
+    : _group(group),
+      _map(map),
+      _count(count)
+{
+}
+
+void XRA1405_VirtualPins::digitalWrite(uint16_t pin, uint8_t value)
+{
+    if (pin >= _count || (entry(pin) >> 4) >= _group.size())
+    {
+        return;
+    }
+    _group.device(entry(pin) >> 4).digitalWrite(entry(pin) & 0x0F, value);
+}
+
+uint8_t XRA1405_VirtualPins::digitalRead(uint16_t pin)
+{
+    if (pin >= _count || (entry(pin) >> 4) >= _group.size())
+    {
+        return LOW;
+    }
+    return _group.device(entry(pin) >> 4).digitalRead(entry(pin) & 0x0F);
+}
+
+void XRA1405_VirtualPins::setPins(const uint32_t *pins)
+{
+    modify(pins, nullptr, SetPins);
+}
+
+void XRA1405_VirtualPins::clearPins(const uint32_t *pins)
+{
+    modify(pins, nullptr, ClearPins);
+}
+
+void XRA1405_VirtualPins::togglePins(const uint32_t *pins)
+{
+    modify(pins, nullptr, TogglePins);
+}
+
+void XRA1405_VirtualPins::writePins(const uint32_t *pins, const uint32_t *values)
+{
+    modify(pins, values, WritePins);
+}
+
+void XRA1405_VirtualPins::readPins(const uint32_t *pins, uint32_t *values)
+{
+    uint8_t chipCount = _group.size();
+    if (chipCount > XRA1405_VPIN_MAX_CHIPS)
+    {
+        chipCount = XRA1405_VPIN_MAX_CHIPS;
+    }
+
+    // Chips past the table's reach are never addressed, so only the reachable ones are read
+    uint16_t inputs[XRA1405_VPIN_MAX_CHIPS];
+    _group.readInputs(inputs, chipCount);
+
+    for (uint16_t word = 0; word < XRA1405_VPIN_WORDS(_count); word++)
+    {
+        uint32_t bits = pins[word];
+        uint32_t levels = 0;
+        while (bits != 0)
+        {
+            uint8_t bit = __builtin_ctz(bits);
+            bits &= bits - 1;
+
+            uint16_t pin = word * 32 + bit;
+            if (pin >= _count)
+            {
+                break;
+            }
+            uint8_t chip = entry(pin) >> 4;
+            if (chip < chipCount && (inputs[chip] & (1 << (entry(pin) & 0x0F))))
+            {
+                levels |= 1UL << bit;
+            }
+        }
+        values[word] = levels;
+    }
+}
+
+void XRA1405_VirtualPins::modify(const uint32_t *pins, const uint32_t *values, Operation operation)
+{
+    // The table cannot address chips past XRA1405_VPIN_MAX_CHIPS, so those are left alone
+    uint8_t chipCount = _group.size();
+    if (chipCount > XRA1405_VPIN_MAX_CHIPS)
+    {
+        chipCount = XRA1405_VPIN_MAX_CHIPS;
+    }
+    if (chipCount == 0)
+    {
+        return;
+    }
+
+    uint16_t andMasks[XRA1405_VPIN_MAX_CHIPS];
+    uint16_t xorMasks[XRA1405_VPIN_MAX_CHIPS];
+    for (uint8_t i = 0; i < chipCount; i++)
+    {
+        andMasks[i] = 0xFFFF;
+        xorMasks[i] = 0x0000;
+    }
+
+    for (uint16_t word = 0; word < XRA1405_VPIN_WORDS(_count); word++)
+    {
+        uint32_t bits = pins[word];
+        while (bits != 0)
+        {
+            uint8_t bit = __builtin_ctz(bits);
+            bits &= bits - 1;
+
+            uint16_t pin = word * 32 + bit;
+            if (pin >= _count)
+            {
+                break;
+            }
+            uint8_t chip = entry(pin) >> 4;
+            if (chip >= chipCount)
+            {
+                continue;
+            }
+
+            // Set: clear then flip to 1, clear: clear, toggle: flip, write: clear then flip to the value
+            uint16_t mask = 1 << (entry(pin) & 0x0F);
+            if (operation != TogglePins)
+            {
+                andMasks[chip] &= ~mask;
+            }
+            if (operation == SetPins || operation == TogglePins ||
+                (operation == WritePins && (values[word] & (1UL << bit))))
+            {
+                xorMasks[chip] |= mask;
+            }
+        }
+    }
+
+    _group.modifyOutputs(andMasks, xorMasks, chipCount);
+}
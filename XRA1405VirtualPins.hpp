@@ -0,0 +1,85 @@
+/**
+ * @file
+ *    XRA1405 Virtual Pins
+ *
+ * @brief
+ *    One flat logical pin space across every chip of a group. Each logical pin resolves through a byte
+ *    table entry, XRA1405_VPIN(chip, pin), so a lookup is one array read; without a table logical pin n
+ *    is pin n % 16 of chip n / 16. The register and bit follow from the pin nibble.
+ *
+ *    Bulk calls take a bitset of logical pins (bit n % 32 of word n / 32), fold it into one AND/XOR
+ *    mask pair per chip and hand that to XRA1405_Group::modifyOutputs(), so every affected OCR pair
+ *    (or single OCR register when only one half changes) is written exactly once, all chips in one
+ *    transaction, and chips without a selected pin get no frame. Enable the cache on the devices so
+ *    the current outputs do not have to be read back first.
+ *
+ * Usage and Examples:
+ *      `XRA1405_VirtualPins io(group); // 12 chips: logical pins 0-191`
+ *      `uint32_t lamps[XRA1405_VPIN_WORDS(192)] = {};`
+ *      `lamps[0] = 0x00010001; lamps[5] = 0x80000000; // Pins 0, 16 and 191`
+ *      `io.setPins(lamps); // Three frames, one per chip, in one transaction`
+ *      `io.digitalWrite(37, LOW);`
+ */
+
+#ifndef XRA1405_VIRTUAL_PINS_HPP
+#define XRA1405_VIRTUAL_PINS_HPP
+
+#include "XRA1405Group.hpp"
+
+// Table entry for a logical pin: chip index in the group (0-15) and pin on that chip (0-15)
+#define XRA1405_VPIN(chip, pin) ((uint8_t)(((chip) << 4) | (pin)))
+
+// Number of 32-bit words in a bitset covering count logical pins
+#define XRA1405_VPIN_WORDS(count) (((count) + 31) / 32)
+
+// The table entry holds a 4-bit chip index
+#define XRA1405_VPIN_MAX_CHIPS 16
+
+class XRA1405_VirtualPins
+{
+public:
+    // Logical pin n is pin n % 16 of chip n / 16, covering every pin of the group
+    explicit XRA1405_VirtualPins(XRA1405_Group &group);
+
+    // Logical pin n is map[n] (built with XRA1405_VPIN); the table must outlive this object
+    XRA1405_VirtualPins(XRA1405_Group &group, const uint8_t *map, uint16_t count);
+
+    uint16_t size() const { return _count; }
+
+    // Single pins, one device call each
+    void digitalWrite(uint16_t pin, uint8_t value);
+    uint8_t digitalRead(uint16_t pin);
+
+    // Drive every logical pin set in pins high, low, or to its opposite level
+    void setPins(const uint32_t *pins);
+    void clearPins(const uint32_t *pins);
+    void togglePins(const uint32_t *pins);
+
+    // Drive every logical pin set in pins to its bit in values
+    void writePins(const uint32_t *pins, const uint32_t *values);
+
+    // Read GSR of every chip in one transaction and fill values with the logical pins set in pins
+    // (the other bits are cleared)
+    void readPins(const uint32_t *pins, uint32_t *values);
+
+private:
+    // Table entry of a logical pin
+    uint8_t entry(uint16_t pin) const { return _map != nullptr ? _map[pin] : (uint8_t)pin; }
+
+    enum Operation
+    {
+        SetPins,
+        ClearPins,
+        TogglePins,
+        WritePins
+    };
+
+    // Fold the selected logical pins into per-chip masks and send them with one modifyOutputs()
+    void modify(const uint32_t *pins, const uint32_t *values, Operation operation);
+
+    XRA1405_Group &_group;
+    const uint8_t *_map;
+    uint16_t _count;
+};
+
+#endif // XRA1405_VIRTUAL_PINS_HPP
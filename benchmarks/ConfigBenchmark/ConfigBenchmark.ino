@@ -0,0 +1,138 @@
+/**
+ * Chip configuration cost
+ *
+ * Brings a chip to the same configuration three ways at several SPI clocks: pin by pin through the
+ * setters, as a hand-built XRA1405_Batch, and with configure() from a compile-time XRA1405_Config.
+ * Output format:
+ *   bench=config_batch clock=10000000 cache=1 iterations=100 ticks_per_op=...  ns_per_op=...
+ * Ticks are CPU cycles on ESP32 (ESP.getCycleCount) and microseconds elsewhere (micros).
+ */
+
+#include <SPI.h>
+#include <XRA1405.hpp>
+
+// Define SPI pins
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+#define SS 5
+
+#define ITERATIONS 100
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define BENCH_TICKS() ESP.getCycleCount()
+#define BENCH_TICKS_PER_US ESP.getCpuFreqMHz()
+#else
+#define BENCH_TICKS() micros()
+#define BENCH_TICKS_PER_US 1
+#endif
+
+static const uint32_t clocks[] = {1000000, 4000000, 10000000, 26000000};
+
+// P0-P7 outputs driven low, P8-P15 inputs with pull-ups and falling edge interrupts
+constexpr XRA1405_Config boardConfig = XRA1405_makeConfig(
+    XRA1405_output(), XRA1405_output(), XRA1405_output(), XRA1405_output(),
+    XRA1405_output(), XRA1405_output(), XRA1405_output(), XRA1405_output(),
+    XRA1405_input(true, INTERRUPT_FALLING), XRA1405_input(true, INTERRUPT_FALLING),
+    XRA1405_input(true, INTERRUPT_FALLING), XRA1405_input(true, INTERRUPT_FALLING),
+    XRA1405_input(true, INTERRUPT_FALLING), XRA1405_input(true, INTERRUPT_FALLING),
+    XRA1405_input(true, INTERRUPT_FALLING), XRA1405_input(true, INTERRUPT_FALLING));
+
+XRA1405 expander(SS);
+
+void report(const char *bench, uint32_t clock, bool cache, uint32_t iterations, uint32_t ticks)
+{
+    Serial.print("bench=");
+    Serial.print(bench);
+    Serial.print(" clock=");
+    Serial.print(clock);
+    Serial.print(" cache=");
+    Serial.print(cache ? 1 : 0);
+    Serial.print(" iterations=");
+    Serial.print(iterations);
+    Serial.print(" ticks_per_op=");
+    Serial.print(ticks / iterations);
+    Serial.print(" ns_per_op=");
+    Serial.println((uint32_t)((uint64_t)ticks * 1000 / BENCH_TICKS_PER_US / iterations));
+}
+
+void configurePinByPin()
+{
+    for (uint8_t pin = 0; pin < 8; pin++)
+    {
+        expander.digitalWrite(pin, LOW);
+        expander.pinMode(pin, OUTPUT);
+    }
+    for (uint8_t pin = 8; pin < 16; pin++)
+    {
+        expander.pinMode(pin, INPUT_PULLUP);
+        expander.setInterrupt(pin, INTERRUPT_FALLING);
+    }
+}
+
+void configureBatch()
+{
+    XRA1405_Batch tx = expander.beginBatch();
+    tx.write16(OCR1, boardConfig.ocr);
+    tx.write16(TSCR1, boardConfig.tscr);
+    tx.write16(PUR1, boardConfig.pur);
+    tx.write16(REIR1, boardConfig.reir);
+    tx.write16(FEIR1, boardConfig.feir);
+    tx.write16(GCR1, boardConfig.gcr);
+    tx.write16(IER1, boardConfig.ier);
+    tx.commit();
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    SPI.begin(SCK, MISO, MOSI);
+    expander.begin();
+
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        expander.setClock(clocks[c]);
+        uint32_t clock = expander.clock();
+
+        for (uint8_t cache = 0; cache < 2; cache++)
+        {
+            if (cache)
+            {
+                expander.enableCache();
+            }
+            else
+            {
+                expander.disableCache();
+            }
+            uint32_t start;
+
+            start = BENCH_TICKS();
+            for (uint32_t i = 0; i < ITERATIONS; i++)
+            {
+                configurePinByPin();
+            }
+            report("config_per_pin", clock, cache, ITERATIONS, BENCH_TICKS() - start);
+
+            start = BENCH_TICKS();
+            for (uint32_t i = 0; i < ITERATIONS; i++)
+            {
+                configureBatch();
+            }
+            report("config_batch", clock, cache, ITERATIONS, BENCH_TICKS() - start);
+
+            start = BENCH_TICKS();
+            for (uint32_t i = 0; i < ITERATIONS; i++)
+            {
+                expander.configure(boardConfig);
+            }
+            report("config_struct", clock, cache, ITERATIONS, BENCH_TICKS() - start);
+        }
+    }
+
+    Serial.println("bench=done");
+}
+
+void loop()
+{
+}
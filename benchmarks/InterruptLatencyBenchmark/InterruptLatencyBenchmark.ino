@@ -0,0 +1,149 @@
+/**
+ * Interrupt-to-callback latency
+ *
+ * Wiring: host STIMULUS_PIN -> expander P0, expander IRQ# -> host IRQ_PIN.
+ * The sketch toggles P0 from the host and measures the time until the host ISR has flagged the event
+ * (irq_flag) and until serviceInterrupts() has delivered the change callback (irq_callback).
+ * Output format:
+ *   bench=irq_callback clock=10000000 iterations=200 ticks_min=... ticks_avg=... ticks_max=... ns_avg=... timeouts=0
+ * Ticks are CPU cycles on ESP32 (ESP.getCycleCount) and microseconds elsewhere (micros).
+ */
+
+#include <SPI.h>
+#include <XRA1405.hpp>
+
+// Define SPI pins
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+#define SS 5
+
+#define IRQ_PIN 4
+#define STIMULUS_PIN 21
+
+#define ITERATIONS 200
+#define TIMEOUT_US 10000
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define BENCH_TICKS() ESP.getCycleCount()
+#define BENCH_TICKS_PER_US ESP.getCpuFreqMHz()
+#else
+#define BENCH_TICKS() micros()
+#define BENCH_TICKS_PER_US 1
+#endif
+
+static const uint32_t clocks[] = {1000000, 4000000, 10000000, 26000000};
+
+XRA1405 expander(SS);
+
+volatile bool callbackSeen = false;
+
+void onChange(XRA1405 &chip, uint16_t changed, uint16_t state, void *context)
+{
+    if (changed & 0x0001)
+    {
+        callbackSeen = true;
+    }
+}
+
+struct Latency
+{
+    uint32_t minimum;
+    uint32_t maximum;
+    uint64_t total;
+    uint32_t samples;
+    uint32_t timeouts;
+};
+
+void addSample(Latency &latency, uint32_t ticks)
+{
+    latency.minimum = ticks < latency.minimum ? ticks : latency.minimum;
+    latency.maximum = ticks > latency.maximum ? ticks : latency.maximum;
+    latency.total += ticks;
+    latency.samples++;
+}
+
+void report(const char *bench, uint32_t clock, const Latency &latency)
+{
+    uint32_t average = latency.samples ? (uint32_t)(latency.total / latency.samples) : 0;
+
+    Serial.print("bench=");
+    Serial.print(bench);
+    Serial.print(" clock=");
+    Serial.print(clock);
+    Serial.print(" iterations=");
+    Serial.print(latency.samples);
+    Serial.print(" ticks_min=");
+    Serial.print(latency.samples ? latency.minimum : 0);
+    Serial.print(" ticks_avg=");
+    Serial.print(average);
+    Serial.print(" ticks_max=");
+    Serial.print(latency.maximum);
+    Serial.print(" ns_avg=");
+    Serial.print((uint32_t)((uint64_t)average * 1000 / BENCH_TICKS_PER_US));
+    Serial.print(" timeouts=");
+    Serial.println(latency.timeouts);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    pinMode(STIMULUS_PIN, OUTPUT);
+    digitalWrite(STIMULUS_PIN, LOW);
+
+    SPI.begin(SCK, MISO, MOSI);
+    expander.begin(true);
+    expander.pinMode(0, INPUT);
+    expander.setInterrupt(0, INTERRUPT_BOTH);
+    expander.clearInterrupts();
+    expander.attachInterrupt(IRQ_PIN, onChange);
+
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        expander.setClock(clocks[c]);
+
+        Latency flagLatency = {0xFFFFFFFF, 0, 0, 0, 0};
+        Latency callbackLatency = {0xFFFFFFFF, 0, 0, 0, 0};
+
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            // Start from a serviced, idle state
+            expander.serviceInterrupts();
+            callbackSeen = false;
+
+            uint32_t startMicros = micros();
+            uint32_t start = BENCH_TICKS();
+            digitalWrite(STIMULUS_PIN, (i & 1) ? LOW : HIGH);
+
+            while (!expander.interruptPending() && micros() - startMicros < TIMEOUT_US)
+            {
+            }
+            uint32_t flagged = BENCH_TICKS();
+
+            while (!callbackSeen && micros() - startMicros < TIMEOUT_US)
+            {
+                expander.serviceInterrupts();
+            }
+            uint32_t delivered = BENCH_TICKS();
+
+            if (!callbackSeen)
+            {
+                flagLatency.timeouts++;
+                callbackLatency.timeouts++;
+                continue;
+            }
+            addSample(flagLatency, flagged - start);
+            addSample(callbackLatency, delivered - start);
+        }
+
+        report("irq_flag", expander.clock(), flagLatency);
+        report("irq_callback", expander.clock(), callbackLatency);
+    }
+
+    Serial.println("bench=done");
+}
+
+void loop()
+{
+}
@@ -0,0 +1,109 @@
+/**
+ * Multi-chip input scan
+ *
+ * Reads the inputs of CHIP_COUNT expanders on one bus, once chip by chip (one transaction each) and
+ * once through XRA1405_Group (one transaction for all of them), at several SPI clocks.
+ * Output format:
+ *   bench=scan_group clock=10000000 chips=3 iterations=1000 ticks_per_op=1520 ns_per_op=6333
+ * Ticks are CPU cycles on ESP32 (ESP.getCycleCount) and microseconds elsewhere (micros).
+ */
+
+#include <SPI.h>
+#include <XRA1405.hpp>
+#include <XRA1405Group.hpp>
+
+// Define SPI pins
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+
+#define CHIP_COUNT 3
+#define ITERATIONS 1000
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define BENCH_TICKS() ESP.getCycleCount()
+#define BENCH_TICKS_PER_US ESP.getCpuFreqMHz()
+#else
+#define BENCH_TICKS() micros()
+#define BENCH_TICKS_PER_US 1
+#endif
+
+static const uint32_t clocks[] = {1000000, 4000000, 10000000, 26000000};
+
+XRA1405 expanders[CHIP_COUNT] = {XRA1405(5), XRA1405(17), XRA1405(16)};
+XRA1405 *devices[CHIP_COUNT] = {&expanders[0], &expanders[1], &expanders[2]};
+XRA1405_Group group(devices, CHIP_COUNT);
+
+void report(const char *bench, uint32_t clock, uint32_t iterations, uint32_t ticks)
+{
+    Serial.print("bench=");
+    Serial.print(bench);
+    Serial.print(" clock=");
+    Serial.print(clock);
+    Serial.print(" chips=");
+    Serial.print(CHIP_COUNT);
+    Serial.print(" iterations=");
+    Serial.print(iterations);
+    Serial.print(" ticks_per_op=");
+    Serial.print(ticks / iterations);
+    Serial.print(" ns_per_op=");
+    Serial.println((uint32_t)((uint64_t)ticks * 1000 / BENCH_TICKS_PER_US / iterations));
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    SPI.begin(SCK, MISO, MOSI);
+    group.begin();
+
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        for (uint8_t i = 0; i < CHIP_COUNT; i++)
+        {
+            expanders[i].setClock(clocks[c]);
+        }
+        uint32_t clock = expanders[0].clock();
+        uint16_t inputs[CHIP_COUNT];
+        uint32_t start;
+
+        start = BENCH_TICKS();
+        for (uint32_t n = 0; n < ITERATIONS; n++)
+        {
+            for (uint8_t i = 0; i < CHIP_COUNT; i++)
+            {
+                inputs[i] = expanders[i].readPort();
+            }
+        }
+        report("scan_per_chip", clock, ITERATIONS, BENCH_TICKS() - start);
+
+        start = BENCH_TICKS();
+        for (uint32_t n = 0; n < ITERATIONS; n++)
+        {
+            group.readInputs(inputs);
+        }
+        report("scan_group", clock, ITERATIONS, BENCH_TICKS() - start);
+
+        // Sixteen digitalRead calls per chip, the pattern the scanner replaces
+        start = BENCH_TICKS();
+        for (uint32_t n = 0; n < ITERATIONS; n++)
+        {
+            for (uint8_t i = 0; i < CHIP_COUNT; i++)
+            {
+                uint16_t value = 0;
+                for (uint8_t pin = 0; pin < 16; pin++)
+                {
+                    value |= (uint16_t)expanders[i].digitalRead(pin) << pin;
+                }
+                inputs[i] = value;
+            }
+        }
+        report("scan_per_pin", clock, ITERATIONS, BENCH_TICKS() - start);
+    }
+
+    Serial.println("bench=done");
+}
+
+void loop()
+{
+}
@@ -0,0 +1,86 @@
+/**
+ * Single-pin write latency
+ *
+ * Times XRA1405::digitalWrite with and without the shadow cache at several SPI clocks.
+ * Every result is one line of space-separated key=value pairs:
+ *   bench=pin_write clock=10000000 cache=1 iterations=1000 ticks_per_op=812 ns_per_op=3383
+ * Ticks are CPU cycles on ESP32 (ESP.getCycleCount) and microseconds elsewhere (micros).
+ */
+
+#include <SPI.h>
+#include <XRA1405.hpp>
+
+// Define SPI pins
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+#define SS 5
+
+#define ITERATIONS 1000
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define BENCH_TICKS() ESP.getCycleCount()
+#define BENCH_TICKS_PER_US ESP.getCpuFreqMHz()
+#else
+#define BENCH_TICKS() micros()
+#define BENCH_TICKS_PER_US 1
+#endif
+
+static const uint32_t clocks[] = {1000000, 4000000, 10000000, 26000000};
+
+XRA1405 expander(SS);
+
+void report(const char *bench, uint32_t clock, bool cache, uint32_t iterations, uint32_t ticks)
+{
+    Serial.print("bench=");
+    Serial.print(bench);
+    Serial.print(" clock=");
+    Serial.print(clock);
+    Serial.print(" cache=");
+    Serial.print(cache ? 1 : 0);
+    Serial.print(" iterations=");
+    Serial.print(iterations);
+    Serial.print(" ticks_per_op=");
+    Serial.print(ticks / iterations);
+    Serial.print(" ns_per_op=");
+    Serial.println((uint32_t)((uint64_t)ticks * 1000 / BENCH_TICKS_PER_US / iterations));
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    SPI.begin(SCK, MISO, MOSI);
+    expander.begin();
+    expander.pinMode(3, OUTPUT);
+
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        expander.setClock(clocks[c]);
+
+        for (uint8_t cache = 0; cache < 2; cache++)
+        {
+            if (cache)
+            {
+                expander.enableCache();
+            }
+            else
+            {
+                expander.disableCache();
+            }
+
+            uint32_t start = BENCH_TICKS();
+            for (uint32_t i = 0; i < ITERATIONS; i++)
+            {
+                expander.digitalWrite(3, (i & 1) ? HIGH : LOW);
+            }
+            report("pin_write", expander.clock(), cache, ITERATIONS, BENCH_TICKS() - start);
+        }
+    }
+
+    Serial.println("bench=done");
+}
+
+void loop()
+{
+}
@@ -0,0 +1,118 @@
+/**
+ * Port-wide read and write throughput
+ *
+ * Times 16-pin port writes, masked updates and full-port reads at several SPI clocks, and eight
+ * single-pin writes for the same 8-bit pattern as a reference. Output format:
+ *   bench=port_write clock=10000000 cache=1 iterations=1000 ticks_per_op=640 ns_per_op=2666
+ * Ticks are CPU cycles on ESP32 (ESP.getCycleCount) and microseconds elsewhere (micros).
+ */
+
+#include <SPI.h>
+#include <XRA1405.hpp>
+
+// Define SPI pins
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+#define SS 5
+
+#define ITERATIONS 1000
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define BENCH_TICKS() ESP.getCycleCount()
+#define BENCH_TICKS_PER_US ESP.getCpuFreqMHz()
+#else
+#define BENCH_TICKS() micros()
+#define BENCH_TICKS_PER_US 1
+#endif
+
+static const uint32_t clocks[] = {1000000, 4000000, 10000000, 26000000};
+
+XRA1405 expander(SS);
+
+void report(const char *bench, uint32_t clock, bool cache, uint32_t iterations, uint32_t ticks)
+{
+    Serial.print("bench=");
+    Serial.print(bench);
+    Serial.print(" clock=");
+    Serial.print(clock);
+    Serial.print(" cache=");
+    Serial.print(cache ? 1 : 0);
+    Serial.print(" iterations=");
+    Serial.print(iterations);
+    Serial.print(" ticks_per_op=");
+    Serial.print(ticks / iterations);
+    Serial.print(" ns_per_op=");
+    Serial.println((uint32_t)((uint64_t)ticks * 1000 / BENCH_TICKS_PER_US / iterations));
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    SPI.begin(SCK, MISO, MOSI);
+    expander.begin(true);
+
+    // P0-P7 outputs, P8-P15 inputs
+    expander.writeRegister16(GCR1, 0xFF00);
+
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        expander.setClock(clocks[c]);
+        uint32_t clock = expander.clock();
+        uint32_t start;
+
+        start = BENCH_TICKS();
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            expander.writePort((uint16_t)i);
+        }
+        report("port_write", clock, true, ITERATIONS, BENCH_TICKS() - start);
+
+        start = BENCH_TICKS();
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            expander.writePortMasked(0x00FF, (uint16_t)i); // Lands in OCR1 only
+        }
+        report("port_write_low_byte", clock, true, ITERATIONS, BENCH_TICKS() - start);
+
+        start = BENCH_TICKS();
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            expander.toggleMask(0x0081);
+        }
+        report("port_toggle", clock, true, ITERATIONS, BENCH_TICKS() - start);
+
+        // The same 8-bit pattern one pin at a time, for comparison with port_write_low_byte
+        start = BENCH_TICKS();
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            for (uint8_t pin = 0; pin < 8; pin++)
+            {
+                expander.digitalWrite(pin, (i >> pin) & 1);
+            }
+        }
+        report("pin_write_x8", clock, true, ITERATIONS, BENCH_TICKS() - start);
+
+        start = BENCH_TICKS();
+        volatile uint16_t sink = 0;
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            sink ^= expander.readPort();
+        }
+        report("port_read", clock, true, ITERATIONS, BENCH_TICKS() - start);
+
+        start = BENCH_TICKS();
+        for (uint32_t i = 0; i < ITERATIONS; i++)
+        {
+            sink ^= expander.digitalRead(8);
+        }
+        report("pin_read", clock, true, ITERATIONS, BENCH_TICKS() - start);
+    }
+
+    Serial.println("bench=done");
+}
+
+void loop()
+{
+}
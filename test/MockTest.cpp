@@ -0,0 +1,825 @@
+// Host test of the driver against XRA1405_MockTransport. Exits non-zero on the first failed check.
+
+#include "XRA1405.hpp"
+#include "XRA1405EventLog.hpp"
+#include "XRA1405Group.hpp"
+#include "XRA1405Matrix.hpp"
+#include "XRA1405Mock.hpp"
+#include "XRA1405OutputQueue.hpp"
+#include "XRA1405Pwm.hpp"
+#include "XRA1405Ring.hpp"
+#include "XRA1405Scanner.hpp"
+#include "XRA1405Sequencer.hpp"
+#include "XRA1405VirtualPins.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(condition)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            exit(1);                                                            \
+        }                                                                       \
+    } while (0)
+
+static void testPins()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin();
+
+    expander.pinMode(3, OUTPUT);
+    expander.digitalWrite(3, HIGH);
+    CHECK((mock.registerValue(GCR1) & 0x08) == 0);
+    CHECK((mock.registerValue(OCR1) & 0x08) != 0);
+    CHECK(expander.digitalRead(3) == HIGH);
+
+    // Inputs come back through PIR
+    expander.pinMode(8, INPUT);
+    mock.setInputs(0x0100);
+    CHECK(expander.digitalRead(8) == HIGH);
+    expander.setInputPolarity(8, true);
+    CHECK(expander.digitalRead(8) == LOW);
+    CHECK(mock.strayFrames() == 0);
+}
+
+static void testCache()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    expander.writePort(0x0000);
+
+    // With the cache a masked write is one frame, nothing is read back
+    mock.resetCounters();
+    expander.writePortMasked(0x00F0, 0x0050);
+    CHECK(mock.frames() == 1);
+    CHECK(mock.registerValue(OCR1) == 0x50);
+
+    // Registers written behind the driver's back are picked up again by resyncCache()
+    mock.setRegisterValue(PUR1, 0x0F);
+    CHECK(expander.resyncCache());
+    mock.resetCounters();
+    expander.setPullUp(4, true);
+    CHECK(mock.frames() == 1);
+    CHECK(mock.registerValue(PUR1) == 0x1F);
+}
+
+static void testInterrupts()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    expander.pinMode(2, INPUT);
+    expander.setInterrupt(2, INTERRUPT_RISING);
+
+    mock.setInputs(0x0004);
+    CHECK(mock.interruptAsserted());
+    uint16_t state = 0;
+    CHECK(expander.readAndClearInterrupts(&state) == 0x0004);
+    CHECK((state & 0x0004) != 0);
+    CHECK(!mock.interruptAsserted());
+
+    // Falling edges are not enabled
+    mock.setInputs(0x0000);
+    CHECK(!mock.interruptAsserted());
+}
+
+static uint16_t serviced;
+
+static void recordChange(XRA1405 &device, uint16_t changedMask, uint16_t state, void *context)
+{
+    (void)device;
+    (void)state;
+    (void)context;
+    serviced |= changedMask;
+}
+
+static void testReadKeepsInterrupts()
+{
+    // IRQ# idles high on the host pin; the host ISR never runs, so only the latch can deliver the edge
+    const uint8_t irqPin = 40;
+    digitalWrite(irqPin, HIGH);
+
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    expander.pinMode(2, INPUT);
+    expander.setInterrupt(2, INTERRUPT_RISING);
+    expander.attachInterrupt(irqPin, recordChange);
+
+    // A plain read clears ISR on the chip before serviceInterrupts() gets to it
+    serviced = 0;
+    mock.setInputs(0x0004);
+    CHECK(expander.digitalRead(2) == HIGH);
+    CHECK(!mock.interruptAsserted());
+    expander.serviceInterrupts();
+    CHECK(serviced == 0x0004);
+
+    serviced = 0;
+    mock.setInputs(0x0000);
+    mock.setInputs(0x0004);
+    CHECK(expander.readPort() == 0x0004);
+    expander.serviceInterrupts();
+    CHECK(serviced == 0x0004);
+
+    expander.detachInterrupt();
+
+    // Without IRQ# the bits wait for readAndClearInterrupts()
+    mock.setInputs(0x0000);
+    mock.setInputs(0x0004);
+    XRA1405_RegisterMap map;
+    expander.dumpRegisters(map, true);
+    CHECK(map.isr1 == 0x04);
+    CHECK(expander.readAndClearInterrupts() == 0x0004);
+}
+
+static void testGroup()
+{
+    // Three chips on one bus: the group opens a single transaction for all of them
+    XRA1405_MockBus bus;
+    XRA1405_MockTransport first(bus);
+    XRA1405_MockTransport second(bus);
+    XRA1405_MockTransport third(bus);
+    XRA1405 chips[] = {XRA1405(first), XRA1405(second), XRA1405(third)};
+    XRA1405 *devices[] = {&chips[0], &chips[1], &chips[2]};
+    XRA1405_Group group(devices, 3);
+    group.begin(true);
+
+    CHECK(first.busKey() == second.busKey());
+    CHECK(first.busKey() == third.busKey());
+
+    XRA1405_Config config = {};
+    config.gcr = 0xFF00; // P0-P7 outputs, P8-P15 inputs
+    config.ifr = 0xFFFF;
+    group.configure(config);
+
+    first.resetCounters();
+    const uint16_t outputs[] = {0x0011, 0x0022, 0x0033};
+    group.writeOutputs(outputs);
+    CHECK(first.transactions() == 1);
+    CHECK(first.registerValue(OCR1) == 0x11);
+    CHECK(second.registerValue(OCR1) == 0x22);
+    CHECK(third.registerValue(OCR1) == 0x33);
+
+    second.setInputs(0xA500);
+    uint16_t inputs[3];
+    group.readInputs(inputs);
+    CHECK(inputs[0] == 0x0011);
+    CHECK(inputs[1] == 0xA522);
+    CHECK(inputs[2] == 0x0033);
+    CHECK(first.transactions() == 2);
+
+    CHECK(first.strayFrames() == 0);
+    CHECK(second.strayFrames() == 0);
+    CHECK(third.strayFrames() == 0);
+
+    // Chips on two buses cannot share a transaction, the group refuses them
+    XRA1405_MockTransport other;
+    XRA1405 stranger(other);
+    XRA1405 *mixed[] = {&chips[0], &stranger};
+    XRA1405_Group mixedGroup(mixed, 2);
+    CHECK(!mixedGroup.begin());
+    CHECK(mixedGroup.size() == 0);
+    mixedGroup.writeOutputs(outputs);
+    CHECK(other.frames() == 0);
+}
+
+static void testVirtualPinsLargeGroup()
+{
+    // Chips past XRA1405_VPIN_MAX_CHIPS are out of the table's reach but must not block the others
+    const uint8_t chipCount = XRA1405_VPIN_MAX_CHIPS + 1;
+    XRA1405_MockBus bus;
+    XRA1405_MockTransport *transports[chipCount];
+    XRA1405 chips[chipCount];
+    XRA1405 *devices[chipCount];
+    for (uint8_t i = 0; i < chipCount; i++)
+    {
+        transports[i] = new XRA1405_MockTransport(bus);
+        chips[i] = XRA1405(*transports[i]);
+        devices[i] = &chips[i];
+    }
+    XRA1405_Group group(devices, chipCount);
+    group.begin(true);
+
+    XRA1405_Config config = {};
+    config.gcr = 0xFF00;
+    config.ifr = 0xFFFF;
+    group.configure(config);
+
+    XRA1405_VirtualPins io(group);
+    uint32_t pins[XRA1405_VPIN_WORDS(XRA1405_VPIN_MAX_CHIPS * 16)] = {};
+    pins[0] = 0x00020001;  // Chip 0 pin 0, chip 1 pin 1
+    pins[7] = 0x00800000u; // Chip 15 pin 7
+    transports[16]->resetCounters();
+    bus.transactions = 0;
+    io.setPins(pins);
+    CHECK(bus.transactions == 1);
+    CHECK(transports[0]->registerValue(OCR1) == 0x01);
+    CHECK(transports[1]->registerValue(OCR1) == 0x02);
+    CHECK(transports[15]->registerValue(OCR1) == 0x80);
+
+    transports[15]->setInputs(0x0100);
+    uint32_t levels[XRA1405_VPIN_WORDS(XRA1405_VPIN_MAX_CHIPS * 16)];
+    pins[7] = 0x01800000u; // Chip 15 pins 7 and 8
+    io.readPins(pins, levels);
+    CHECK(levels[0] == 0x00020001);
+    CHECK(levels[7] == 0x01800000u);
+    CHECK(transports[16]->frames() == 0);
+
+    for (uint8_t i = 0; i < chipCount; i++)
+    {
+        delete transports[i];
+    }
+}
+
+static void testBatch()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    mock.resetCounters();
+
+    // One transaction, one CS frame per queued write: pairs take 3 bytes, single registers 2
+    XRA1405_Batch batch = expander.beginBatch();
+    batch.write16(GCR1, 0x00FF);
+    batch.write(PUR1, 0x0F);
+    batch.write16(OCR1, 0x1234);
+    CHECK(batch.size() == 3);
+    CHECK(batch.commit() == 3);
+    CHECK(batch.size() == 0);
+    CHECK(mock.transactions() == 1);
+    CHECK(mock.frames() == 3);
+    CHECK(mock.bytes() == 3 + 2 + 3);
+    CHECK(mock.registerValue(GCR2) == 0x00);
+    CHECK(mock.registerValue(PUR1) == 0x0F);
+    CHECK(mock.registerValue(OCR2) == 0x12);
+
+    // The shadow cache followed the batch, so the read-modify-write below needs no read frame
+    mock.resetCounters();
+    expander.digitalWrite(0, HIGH);
+    CHECK(mock.frames() == 1);
+    CHECK(mock.registerValue(OCR1) == 0x35);
+
+    // A full batch sends itself and keeps queueing
+    mock.resetCounters();
+    XRA1405_Batch large = expander.beginBatch();
+    for (uint8_t i = 0; i <= XRA1405_BATCH_CAPACITY; i++)
+    {
+        large.write(PIR1, i);
+    }
+    CHECK(mock.frames() == XRA1405_BATCH_CAPACITY);
+    CHECK(large.size() == 1);
+    CHECK(large.commit() == 1);
+    CHECK(mock.frames() == XRA1405_BATCH_CAPACITY + 1);
+    CHECK(mock.transactions() == 2);
+    CHECK(mock.registerValue(PIR1) == XRA1405_BATCH_CAPACITY);
+    CHECK(mock.strayFrames() == 0);
+}
+
+static void testRegisterSnapshots()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+
+    XRA1405_Config config = {};
+    config.ocr = 0xA55A;
+    config.pir = 0x0F00;
+    config.gcr = 0xFF00;
+    config.pur = 0x3C00;
+    config.ier = 0x0100;
+    config.tscr = 0x0003;
+    config.reir = 0x0100;
+    config.feir = 0x0000;
+    config.ifr = 0x00FF;
+    expander.configure(config);
+
+    // Without readState GSR and ISR are left alone and come back as 0
+    XRA1405_RegisterMap map;
+    mock.resetCounters();
+    expander.dumpRegisters(map, false);
+    CHECK(mock.transactions() == 1);
+    CHECK(map.ocr1 == 0x5A && map.ocr2 == 0xA5);
+    CHECK(map.pur2 == 0x3C && map.tscr1 == 0x03 && map.ifr1 == 0xFF);
+    CHECK(map.gsr1 == 0 && map.gsr2 == 0 && map.isr1 == 0 && map.isr2 == 0);
+
+    // The snapshot recreates the configuration on a chip fresh from power-on
+    XRA1405_MockTransport freshMock;
+    XRA1405 fresh(freshMock);
+    fresh.begin();
+    freshMock.resetCounters();
+    fresh.restoreRegisters(map);
+    CHECK(freshMock.transactions() == 1);
+    for (uint8_t registerCommand = OCR1; registerCommand <= IFR2; registerCommand += 2)
+    {
+        if (registerCommand != ISR1 && registerCommand != ISR2)
+        {
+            CHECK(freshMock.registerValue(registerCommand) == mock.registerValue(registerCommand));
+        }
+    }
+    CHECK(freshMock.strayFrames() == 0);
+}
+
+static void testRepairRegisters()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+
+    // Nothing to compare against without the cache
+    expander.begin();
+    CHECK(expander.repairRegisters() == 0);
+
+    expander.enableCache();
+    expander.pinMode(3, OUTPUT);
+    expander.digitalWrite(3, LOW);
+    expander.pinMode(10, INPUT);
+    expander.setInterrupt(10, INTERRUPT_RISING);
+    CHECK(expander.repairRegisters() == 0);
+
+    // Brown-out: the chip is back at its power-on values, only the drifted registers are rewritten
+    mock.reset();
+    mock.resetCounters();
+    CHECK(expander.repairRegisters() == 3); // OCR1, GCR1 and IER2
+    CHECK(mock.registerValue(OCR1) == 0xF7);
+    CHECK(mock.registerValue(GCR1) == 0xF7);
+    CHECK(mock.registerValue(IER2) == 0x04);
+    CHECK(mock.transactions() == 2); // One for the paired reads, one for the rewrite batch
+    CHECK(expander.repairRegisters() == 0);
+
+    // Pairs outside the selection are not looked at
+    mock.setRegisterValue(PUR1, 0x55);
+    CHECK(expander.repairRegisters() == 0);
+    CHECK(expander.repairRegisters(XRA1405_CHECK_ALL) == 2); // PUR1, and REIR2 from the brown-out
+    CHECK(mock.registerValue(PUR1) == 0x00);
+    CHECK(mock.registerValue(REIR2) == 0x04);
+}
+
+static void testSelfTest()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    expander.pinMode(4, OUTPUT);
+    expander.digitalWrite(4, LOW);
+
+    XRA1405_RegisterMap before;
+    expander.dumpRegisters(before, false);
+
+    XRA1405_SelfTestResult result;
+    CHECK(expander.selfTest(result, true));
+    CHECK(result.passed && result.errorBits == 0);
+
+    XRA1405_RegisterMap after;
+    expander.dumpRegisters(after, false);
+    CHECK(memcmp(&before, &after, sizeof(before)) == 0);
+
+    // A marginal MISO line at the device clock: the patterns fail on bit 0 of each register,
+    // and the originals are still put back (at XRA1405_SPI_CLOCK_MIN)
+    mock.setMaxClock(XRA1405_SPI_CLOCK / 4);
+    CHECK(!expander.selfTest(result));
+    CHECK(!result.passed);
+    CHECK(result.errorBits == 0x0101);
+    mock.setMaxClock(0xFFFFFFFF);
+    expander.dumpRegisters(after, false);
+    CHECK(memcmp(&before, &after, sizeof(before)) == 0);
+
+    // The clock search settles at or below what the bus can take and leaves the device clock alone
+    mock.setMaxClock(XRA1405_SPI_CLOCK / 4);
+    CHECK(expander.qualifyClock(result, true));
+    CHECK(result.maxClock > 0 && result.maxClock <= XRA1405_SPI_CLOCK / 4);
+    CHECK(expander.clock() == XRA1405_SPI_CLOCK);
+    mock.setMaxClock(0xFFFFFFFF);
+    expander.dumpRegisters(after, false);
+    CHECK(memcmp(&before, &after, sizeof(before)) == 0);
+
+    // A runtime ceiling clamps the device clock and bounds the clock search
+    CHECK(!expander.setClockLimits(2000000, 1000000));
+    CHECK(expander.setClockLimits(XRA1405_SPI_CLOCK_MIN, 15000000));
+    CHECK(expander.clock() == 15000000);
+    expander.setClock(XRA1405_SPI_CLOCK);
+    CHECK(expander.clock() == 15000000);
+    CHECK(expander.qualifyClock(result));
+    CHECK(result.maxClock == 15000000);
+    CHECK(mock.strayFrames() == 0);
+}
+
+static void testInputGating()
+{
+    const uint8_t irqPin = 41;
+    digitalWrite(irqPin, HIGH);
+
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    expander.pinMode(2, INPUT);
+    expander.pinMode(3, INPUT);
+    expander.setInterrupt(2, INTERRUPT_BOTH);
+    expander.attachInterrupt(irqPin, recordChange);
+    expander.setInputGating(true);
+
+    // The first read fetches GSR, later reads of covered pins are served from it while IRQ# is idle
+    CHECK(expander.digitalRead(2) == LOW);
+    mock.resetCounters();
+    CHECK(expander.digitalRead(2) == LOW);
+    CHECK(mock.frames() == 0);
+
+    // P3 has no interrupt, so nothing would tell us it changed
+    mock.setInputs(0x0008);
+    CHECK(expander.digitalRead(3) == HIGH);
+    CHECK(mock.frames() > 0);
+
+    // An edge on P2 asserts IRQ#; the next read goes to the chip and keeps the interrupt
+    serviced = 0;
+    mock.setInputs(0x000C);
+    CHECK(mock.interruptAsserted());
+    digitalWrite(irqPin, LOW);
+    CHECK(expander.digitalRead(2) == HIGH);
+    CHECK(!mock.interruptAsserted());
+    digitalWrite(irqPin, HIGH);
+
+    mock.resetCounters();
+    CHECK(expander.digitalRead(2) == HIGH);
+    CHECK(mock.frames() == 0);
+    expander.serviceInterrupts();
+    CHECK(serviced == 0x0004);
+
+    expander.detachInterrupt();
+}
+
+static uint8_t scanChip;
+static uint16_t scanChanged;
+static uint16_t scanState;
+
+static void recordScanChange(uint8_t chip, uint16_t changedMask, uint16_t state, void *context)
+{
+    (void)context;
+    scanChip = chip;
+    scanChanged |= changedMask;
+    scanState = state;
+}
+
+static void testScannerDebounce()
+{
+    XRA1405_MockBus bus;
+    XRA1405_MockTransport first(bus);
+    XRA1405_MockTransport second(bus);
+    XRA1405 chips[] = {XRA1405(first), XRA1405(second)};
+    XRA1405 *devices[] = {&chips[0], &chips[1]};
+    XRA1405_Group group(devices, 2);
+    CHECK(group.begin(true));
+
+    XRA1405_Scanner scanner(group, 0);
+    scanner.begin(recordScanChange);
+
+    // A change is reported on the third scan that sees it, each scan is one transaction
+    scanChanged = 0;
+    second.setInputs(0x0101);
+    bus.transactions = 0;
+    CHECK(!scanner.scan());
+    CHECK(!scanner.scan());
+    CHECK(scanChanged == 0);
+    CHECK(scanner.scan());
+    CHECK(bus.transactions == 3);
+    CHECK(scanChip == 1 && scanChanged == 0x0101 && scanState == 0x0101);
+    CHECK(scanner.state(1) == 0x0101);
+    CHECK(scanner.takeChanges(1) == 0x0101);
+    CHECK(scanner.takeChanges(1) == 0);
+
+    // A glitch shorter than three scans never shows up
+    scanChanged = 0;
+    second.setInputs(0x0103);
+    CHECK(!scanner.scan());
+    CHECK(!scanner.scan());
+    second.setInputs(0x0101);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        CHECK(!scanner.scan());
+    }
+    CHECK(scanChanged == 0 && scanner.state(1) == 0x0101);
+
+    // Pins left out of the debounce mask report on the first scan
+    scanner.setDebounceMask(0, 0xFFFE);
+    first.setInputs(0x0003);
+    CHECK(scanner.scan());
+    CHECK(scanChip == 0 && scanChanged == 0x0001);
+    CHECK(scanner.state(0) == 0x0001);
+    CHECK(!scanner.scan());
+    CHECK(scanner.scan());
+    CHECK(scanner.state(0) == 0x0003);
+}
+
+static void testMatrixGhosting()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+
+    XRA1405_Matrix keypad(expander, 4, 4, 0);
+    keypad.begin();
+    mock.setInputs(0xFF00); // Column pull-ups
+
+    // Row 1, column 2 is debounced like the scanner: three sweeps
+    mock.setKeyMatrix(1ULL << (1 * 8 + 2));
+    CHECK(!keypad.scan());
+    CHECK(!keypad.scan());
+    CHECK(keypad.scan());
+    CHECK(keypad.pressed(1, 2));
+    CHECK(keypad.state() == 1ULL << 10);
+    CHECK(keypad.takeChanges() == 1ULL << 10);
+
+    // Three corners of a rectangle make the fourth look pressed too: those sweeps are dropped
+    mock.setKeyMatrix((1ULL << 0) | (1ULL << 1) | (1ULL << 8));
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        CHECK(!keypad.scan());
+    }
+    CHECK(keypad.ghostedScans() == 3);
+    CHECK(keypad.state() == 1ULL << 10);
+
+    // Two keys on one row are no rectangle
+    mock.setKeyMatrix((1ULL << 0) | (1ULL << 1));
+    CHECK(!keypad.scan());
+    CHECK(!keypad.scan());
+    CHECK(keypad.scan());
+    CHECK(keypad.state() == 0x0003);
+    CHECK(keypad.ghostedScans() == 3);
+    CHECK(mock.registerValue(TSCR1) == 0x0F); // Every row released after the sweep
+    CHECK(mock.strayFrames() == 0);
+}
+
+static void testPwmPlanes()
+{
+    XRA1405_MockTransport mock;
+    XRA1405 chip(mock);
+    XRA1405 *devices[] = {&chip};
+    XRA1405_Group group(devices, 1);
+    CHECK(group.begin(true));
+    chip.writeRegister16(GCR1, 0x0000);
+    chip.writeRegister16(OCR1, 0x0020); // P5 is not under PWM and must keep its level
+
+    // A zero base period makes every poll() due, one plane per call
+    XRA1405_Pwm pwm(group, 0);
+    pwm.setDuty(0, 0, 0x81);
+    pwm.setDuty(0, 1, 0x01);
+    CHECK(pwm.duty(0, 0) == 0x81);
+
+    mock.resetCounters();
+    pwm.start();
+    CHECK(mock.registerValue(OCR1) == 0x23); // Plane 0
+    CHECK(pwm.poll());
+    CHECK(mock.registerValue(OCR1) == 0x20); // Plane 1
+    for (uint8_t plane = 2; plane < 7; plane++)
+    {
+        CHECK(!pwm.poll()); // Same as plane 1, not written
+    }
+    CHECK(pwm.poll());
+    CHECK(mock.registerValue(OCR1) == 0x21); // Plane 7
+    CHECK(pwm.writes() == 3);
+    CHECK(mock.frames() == 3); // OCR2 never changes, so only OCR1 goes out
+
+    // The next period starts over at plane 0
+    CHECK(pwm.poll());
+    CHECK(mock.registerValue(OCR1) == 0x23);
+
+    pwm.stop();
+    CHECK(!pwm.running());
+    CHECK(!pwm.poll());
+    CHECK(mock.registerValue(OCR2) == 0x00);
+}
+
+static void testSequencer()
+{
+    XRA1405_MockBus bus;
+    XRA1405_MockTransport first(bus);
+    XRA1405_MockTransport second(bus);
+    XRA1405 chips[] = {XRA1405(first), XRA1405(second)};
+    XRA1405 *devices[] = {&chips[0], &chips[1]};
+    XRA1405_Group group(devices, 2);
+    CHECK(group.begin(true));
+    XRA1405_Config config = {};
+    config.ifr = 0xFFFF;
+    group.configure(config);
+
+    static const uint16_t patterns[] = {0x0001, 0x0100, 0x0002, 0x0200, 0x0004, 0x0400};
+    XRA1405_Sequencer sequencer(group);
+
+    // Once through: step 0 goes out at start(), each poll() writes the next one
+    sequencer.load(patterns, 3, (uint32_t)0, false);
+    CHECK(sequencer.start());
+    CHECK(first.registerValue(OCR1) == 0x01 && second.registerValue(OCR2) == 0x01);
+    CHECK(sequencer.poll());
+    CHECK(first.registerValue(OCR1) == 0x02 && second.registerValue(OCR2) == 0x02);
+    CHECK(sequencer.poll());
+    CHECK(first.registerValue(OCR1) == 0x04 && second.registerValue(OCR2) == 0x04);
+    CHECK(!sequencer.running());
+    CHECK(!sequencer.poll());
+    CHECK(first.registerValue(OCR1) == 0x04);
+
+    // Repeating with per-step hold times wraps back to step 0
+    static const uint32_t holdMicros[] = {0, 0, 0};
+    sequencer.load(patterns, 3, holdMicros);
+    CHECK(sequencer.start());
+    CHECK(sequencer.poll());
+    CHECK(sequencer.poll());
+    CHECK(sequencer.poll());
+    CHECK(sequencer.running());
+    CHECK(sequencer.step() == 1);
+    CHECK(first.registerValue(OCR1) == 0x01 && second.registerValue(OCR2) == 0x01);
+
+    sequencer.stop();
+    CHECK(!sequencer.poll());
+    CHECK(first.strayFrames() == 0 && second.strayFrames() == 0);
+}
+
+static void testVirtualPinsFolding()
+{
+    XRA1405_MockBus bus;
+    XRA1405_MockTransport first(bus);
+    XRA1405_MockTransport second(bus);
+    XRA1405_MockTransport third(bus);
+    XRA1405 chips[] = {XRA1405(first), XRA1405(second), XRA1405(third)};
+    XRA1405 *devices[] = {&chips[0], &chips[1], &chips[2]};
+    XRA1405_Group group(devices, 3);
+    CHECK(group.begin(true));
+    XRA1405_Config config = {};
+    config.gcr = 0xFF00;
+    config.ifr = 0xFFFF;
+    group.configure(config);
+
+    // Logical pins 0-3 are scattered over chips 0 and 2, chip 1 is not mapped
+    static const uint8_t map[] = {XRA1405_VPIN(2, 3), XRA1405_VPIN(0, 9), XRA1405_VPIN(2, 4), XRA1405_VPIN(0, 0)};
+    XRA1405_VirtualPins io(group, map, 4);
+    CHECK(io.size() == 4);
+
+    first.resetCounters();
+    second.resetCounters();
+    third.resetCounters();
+    uint32_t pins[1] = {0x0000000F};
+    io.setPins(pins);
+    CHECK(first.transactions() == 1);
+    CHECK(first.registerValue(OCR1) == 0x01 && first.registerValue(OCR2) == 0x02);
+    CHECK(third.registerValue(OCR1) == 0x18);
+    CHECK(first.frames() == 1 && third.frames() == 1 && second.frames() == 0); // Both halves in one frame
+
+    // Every command folds into one mask pair per chip
+    uint32_t toggled[1] = {0x00000005};
+    io.togglePins(toggled);
+    CHECK(third.registerValue(OCR1) == 0x00);
+    CHECK(first.frames() == 1); // Chip 0 was not touched
+
+    uint32_t written[1] = {0x00000003};
+    uint32_t values[1] = {0x00000001};
+    io.writePins(written, values);
+    CHECK(third.registerValue(OCR1) == 0x08);
+    CHECK(first.registerValue(OCR2) == 0x00);
+
+    uint32_t levels[1];
+    io.readPins(pins, levels);
+    CHECK(levels[0] == 0x00000009);
+    CHECK(io.digitalRead(3) == HIGH && io.digitalRead(2) == LOW);
+}
+
+static void testRing()
+{
+    XRA1405_Ring<uint16_t, 4> ring;
+    CHECK(ring.empty());
+    CHECK(ring.capacity() == 4);
+
+    for (uint16_t i = 1; i <= 4; i++)
+    {
+        CHECK(ring.push(i));
+    }
+    CHECK(!ring.push(5)); // Full
+
+    uint16_t value;
+    for (uint16_t i = 1; i <= 4; i++)
+    {
+        CHECK(ring.pop(value) && value == i);
+    }
+    CHECK(!ring.pop(value));
+    CHECK(ring.empty());
+
+    // Several laps around the storage keep the order
+    for (uint16_t i = 0; i < 10; i++)
+    {
+        CHECK(ring.push(i));
+        CHECK(ring.push(i + 100));
+        CHECK(ring.pop(value) && value == i);
+        CHECK(ring.pop(value) && value == i + 100);
+    }
+}
+
+static void testEventLog()
+{
+    const uint8_t irqPin = 43;
+    digitalWrite(irqPin, HIGH);
+
+    XRA1405_MockTransport mock;
+    XRA1405 expander(mock);
+    expander.begin(true);
+    expander.pinMode(2, INPUT);
+    expander.setInterrupt(2, INTERRUPT_RISING);
+
+    static XRA1405_EventLog log;
+    CHECK(log.attach(expander, irqPin, 7));
+
+    // The IRQ# event reaches the log through serviceInterrupts(), tagged with the chip number
+    mock.setInputs(0x0004);
+    expander.readPort();
+    expander.serviceInterrupts();
+    XRA1405_Event event;
+    CHECK(log.pop(event));
+    CHECK(event.chip == 7 && event.changedMask == 0x0004 && (event.state & 0x0004) != 0);
+    CHECK(event.timestamp == expander.interruptMicros());
+    CHECK(log.empty());
+
+    // Scanner records come in through recordScan() in order
+    XRA1405_EventLog::recordScan(1, 0x0010, 0x0010, &log);
+    XRA1405_EventLog::recordScan(2, 0x0020, 0x0000, &log);
+    XRA1405_Event events[4];
+    CHECK(log.drain(events, 4) == 2);
+    CHECK(events[0].chip == 1 && events[0].changedMask == 0x0010);
+    CHECK(events[1].chip == 2 && events[1].state == 0x0000);
+
+    // A full ring drops new records and counts them
+    for (uint16_t i = 0; i < XRA1405_EVENTLOG_CAPACITY + 2; i++)
+    {
+        log.record(0, 1, i, i);
+    }
+    CHECK(log.dropped() == 2);
+    CHECK(log.pop(event) && event.state == 0);
+
+    expander.detachInterrupt();
+}
+
+static void testOutputQueue()
+{
+    XRA1405_MockBus bus;
+    XRA1405_MockTransport first(bus);
+    XRA1405_MockTransport second(bus);
+    XRA1405 chips[] = {XRA1405(first), XRA1405(second)};
+    XRA1405 *devices[] = {&chips[0], &chips[1]};
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        chips[i].begin(true);
+        chips[i].writeRegister16(GCR1, 0x0000);
+        chips[i].writeRegister16(OCR1, 0x0000);
+    }
+
+    XRA1405_OutputQueue queue(devices, 2);
+
+    // Commands fold in posting order into one OCR write per chip
+    CHECK(queue.setMask(0, 0x0003));
+    CHECK(queue.toggleMask(0, 0x0006)); // 0x0003 ^ 0x0006
+    CHECK(queue.setMask(0, 0x0100));
+    CHECK(queue.clearMask(0, 0x0100));
+    CHECK(queue.writeMasked(1, 0x00FF, 0xFFA5));
+    CHECK(!queue.setMask(2, 0x0001)); // No such chip
+    first.resetCounters();
+    second.resetCounters();
+    CHECK(queue.drain() == 2);
+    CHECK(first.registerValue(OCR1) == 0x05 && first.registerValue(OCR2) == 0x00);
+    CHECK(second.registerValue(OCR1) == 0xA5 && second.registerValue(OCR2) == 0x00);
+    CHECK(first.frames() == 1 && second.frames() == 1);
+    CHECK(queue.drain() == 0);
+
+    // A full ring drops the command and counts it
+    for (uint16_t i = 0; i < XRA1405_OUTPUT_QUEUE_CAPACITY; i++)
+    {
+        CHECK(queue.toggleMask(1, 0x8000));
+    }
+    CHECK(!queue.toggleMask(1, 0x8000));
+    CHECK(queue.dropped() == 1);
+    CHECK(queue.drain() == 1);
+    CHECK(second.registerValue(OCR2) == 0x00); // An even number of toggles
+}
+
+int main()
+{
+    testPins();
+    testCache();
+    testInterrupts();
+    testReadKeepsInterrupts();
+    testGroup();
+    testVirtualPinsLargeGroup();
+    testBatch();
+    testRegisterSnapshots();
+    testRepairRegisters();
+    testSelfTest();
+    testInputGating();
+    testScannerDebounce();
+    testMatrixGhosting();
+    testPwmPlanes();
+    testSequencer();
+    testVirtualPinsFolding();
+    testRing();
+    testEventLog();
+    testOutputQueue();
+    printf("XRA1405 mock tests passed\n");
+    return 0;
+}
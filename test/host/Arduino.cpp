@@ -0,0 +1,71 @@
+#include "Arduino.h"
+#include "SPI.h"
+
+#include <chrono>
+#include <thread>
+
+SPIClass SPI;
+
+static uint8_t pinLevels[256];
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    pinLevels[pin] = value != LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pinLevels[pin];
+}
+
+unsigned long micros()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+int digitalPinToInterrupt(uint8_t pin)
+{
+    return pin;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode)
+{
+    (void)interrupt;
+    (void)handler;
+    (void)mode;
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+    (void)interrupt;
+}
+
+void noInterrupts()
+{
+}
+
+void interrupts()
+{
+}
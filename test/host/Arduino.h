@@ -0,0 +1,53 @@
+/**
+ * @file
+ *    Host Arduino Shim
+ *
+ * @brief
+ *    The part of the Arduino core the XRA1405 driver uses, enough to build it for a desktop test run
+ *    against XRA1405_MockTransport. Pins are plain memory, interrupts are never raised and micros()
+ *    runs off the host clock.
+ */
+
+#ifndef XRA1405_HOST_ARDUINO_H
+#define XRA1405_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+
+// From the core's binary.h, used by the register command macros
+#define B01111111 127
+#define B10000000 128
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+#endif // XRA1405_HOST_ARDUINO_H
@@ -0,0 +1,46 @@
+/**
+ * @file
+ *    Host SPI Shim
+ *
+ * @brief
+ *    SPIClass and SPISettings with the members the driver calls. Nothing is wired to it: transfers
+ *    shift in zeros, so host tests talk to the chip through XRA1405_MockTransport instead.
+ */
+
+#ifndef XRA1405_HOST_SPI_H
+#define XRA1405_HOST_SPI_H
+
+#include "Arduino.h"
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define SPI_MODE0 0x00
+
+class SPISettings
+{
+public:
+    SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode)
+    {
+    }
+
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass
+{
+public:
+    void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+    void end() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t) { return 0x00; }
+    void transfer(void *data, uint32_t length) { memset(data, 0, length); }
+};
+
+extern SPIClass SPI;
+
+#endif // XRA1405_HOST_SPI_H